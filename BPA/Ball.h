@@ -0,0 +1,50 @@
+#ifndef BallPivotingBall
+#define BallPivotingBall
+
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <glm/glm.hpp>
+
+#include "BallPivotingAlgorithm.h"
+#include "Simd.h"
+
+namespace BPA {
+
+	//faces in mesh structure, contains the slots of three points
+	struct MeshFace : std::array<std::uint32_t, 3> {};
+
+	template <typename Index>
+	auto triangle(const Index& index, MeshFace f) -> Triangle {
+		return {index.position(f[0]), index.position(f[1]), index.position(f[2])};
+	}
+
+	//compute the ball's center via it's connecting face and radius, return its center's position
+	inline auto computeBallCenter(const Triangle& f, float radius) -> std::optional<glm::vec3> {
+		const glm::vec3 ac = f[2] - f[0];
+		const glm::vec3 ab = f[1] - f[0];
+		const glm::vec3 abXac = glm::cross(ab, ac);
+		const glm::vec3 toCircumCircleCenter = (glm::cross(abXac, ab) * glm::dot(ac, ac) + glm::cross(ac, abXac) * glm::dot(ab, ab)) / (2 * glm::dot(abXac, abXac));
+		const glm::vec3 circumCircleCenter = f[0] + toCircumCircleCenter;
+
+		const auto heightSquared = radius * radius - glm::dot(toCircumCircleCenter, toCircumCircleCenter);
+		if (!(heightSquared >= 0)) // also rejects the NaN of degenerate faces, e.g. from points with duplicate coordinates
+			return {};
+		auto ballCenter = circumCircleCenter + f.normal() * std::sqrt(heightSquared);
+		return ballCenter;
+	}
+
+	//a point inside the ball by less than emptyBallTolerance times the radius still counts as on its surface. the points the ball
+	//touches are only on it up to rounding, which grows with the radius, so the tolerance is relative to it
+	constexpr float emptyBallTolerance = 1e-3f;
+
+	//check whether the current ball doesn't include any of the count positions inside it, if so such pivoting way is illegal
+	inline auto ballIsEmpty(glm::vec3 ballCenter, SoAPositions positions, std::uint32_t count, float radius, AnyWithinRadiusKernel anyWithinRadius) -> bool {
+		const auto inner = radius * (1 - emptyBallTolerance);
+		return !anyWithinRadius(positions, 0, count, ballCenter, inner * inner);
+	}
+}
+
+#endif
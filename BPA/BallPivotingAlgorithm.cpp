@@ -1,381 +1,894 @@
 #include "BallPivotingAlgorithm.h"
+#include "Ball.h"
+#include "EdgeTable.h"
+#include "Grid.h"
+#include "KdTree.h"
+#include "NeighborLists.h"
+#include "Octree.h"
+#include "SeedSearch.h"
+#include "Simd.h"
+#include "ThreadPool.h"
 
 #include <algorithm>
-#include <deque>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <iostream>
-#include <sstream>
 #include <numeric>
 #include <tuple>
 #include <math.h>
 
-#include "glm/gtx/io.hpp"
-
 using namespace glm;
 
 namespace BPA {
 	
-	//points in mesh structure, which have 'used' indicating whether this point has been used for an iteration of ball,
-	//and a set of edges this point has
-	struct MeshPoint {
-		vec3 pos;
-		vec3 normal;
-		bool used = false;
-		std::vector<MeshEdge*> edges;
-	};
 	//each edge has three status: active(new added edges, good to pivot on), 
 	//inner(edges has already been pivoted), boundary(tried to pivot, but no target points are found)
-	enum class EdgeStatus {
+	enum class EdgeStatus : std::uint32_t {
 		active,
 		inner,
 		boundary
 	};
+	//the index of an edge in the edge pool, noEdge stands for none
+	constexpr std::uint32_t noEdge = std::numeric_limits<std::uint32_t>::max();
+	//the opposite point shares a word with the status, so there can be at most maxPoints points
+	constexpr std::size_t maxPoints = std::size_t{1} << 30;
 	//edges in mesh structure, which have two points and an opposite point(the point reached after pivoting), the center
-	//of such pivoting, the next and previous edges, and  its status
+	//of such pivoting, the next and previous edges, and  its status. the edges refer to each other by their index in the
+	//edge pool and the status takes the two top bits of the opposite point, so an edge is 32 bytes and two share a cache line
 	struct MeshEdge {
-		MeshPoint* a;
-		MeshPoint* b;
-		MeshPoint* opposite;
-		vec3 center;
-		MeshEdge* prev;
-		MeshEdge* next;
-		EdgeStatus status = EdgeStatus::active;
-	};
-	//faces in mesh structure, contains thress mesh points
-	struct MeshFace : std::array<MeshPoint*, 3>{
-		auto normal() const {
-			return normalize(cross((*this)[0]->pos - (*this)[1]->pos, (*this)[0]->pos - (*this)[2]->pos));
-		}
-	};
-	//the first seed result (face and the ball's center)
-	struct SeedResult {
-		MeshFace f;
-		vec3 ballCenter;
-	};
-	//the pivot result after the BPA, which is the target point and the corresponding ball's center
-	struct PivotResult {
-		MeshPoint* p;
+		std::uint32_t a;
+		std::uint32_t b;
+		std::uint32_t opposite : 30;
+		EdgeStatus status : 2;
 		vec3 center;
+		std::uint32_t prev;
+		std::uint32_t next;
 	};
-
-	//a cube in the total space, stores all the points inside it
-	using Cell = std::vector<MeshPoint>;
-
-	//the sum of all cubes, which is the entire input space covering all the points
-	struct Grid {
-		Grid(const std::vector<Point>& points, float radius)
-			: cellSize(radius * 2) {
-			lower = points.front().pos;
-			upper = points.front().pos;
-
-			for (const auto& p : points) {
-				for (auto i = 0; i < 3; i++) {
-					lower[i] = std::min(lower[i], p.pos[i]);
-					upper[i] = std::max(upper[i], p.pos[i]);
-				}
+	static_assert(sizeof(MeshEdge) == 32, "an edge should fill half a cache line");
+
+	//the edges of one reconstruction. they are stored in blocks of blockSize edges, so the pool grows without moving the edges
+	//and never holds a copy of them while growing, as one array would. inner edges are released once nothing refers to them
+	//any more and their slots are handed out again first, so the pool grows with the front rather than with the mesh
+	struct EdgePool {
+		static constexpr std::uint32_t blockBits = 12;
+		static constexpr std::uint32_t blockSize = 1u << blockBits;
+
+		auto add(const MeshEdge& edge) -> std::uint32_t {
+			if (!released.empty()) {
+				const auto e = released.back();
+				released.pop_back();
+				(*this)[e] = edge;
+				return e;
 			}
-
-			dims = max(ivec3{ceil((upper - lower) / cellSize)}, ivec3{1});
-
-			cells.resize(dims.x * dims.y * dims.z);
-			for (const auto& p : points)
-				cell(cellIndex(p.pos)).push_back({p.pos, p.normal});
+			return append(edge);
 		}
 
-		auto cellIndex(vec3 point) -> ivec3 {
-			const auto index = ivec3{(point - lower) / cellSize};
-			return clamp(index, ivec3{}, dims - 1);
+		//adds the edge in a new slot behind all others, also if there are released ones
+		auto append(const MeshEdge& edge) -> std::uint32_t {
+			if (size % blockSize == 0)
+				blocks.emplace_back(new MeshEdge[blockSize]);
+			const auto e = size++;
+			(*this)[e] = edge;
+			return e;
 		}
 
-		auto cell(ivec3 index) -> Cell& {
-			return cells[index.z * dims.x * dims.y + index.y * dims.x + index.x];
+		void release(std::uint32_t e) {
+			released.push_back(e);
 		}
 
-		auto sphericalNeighborhood(vec3 point, std::initializer_list<vec3> ignore) -> std::vector<MeshPoint*> {
-			std::vector<MeshPoint*> result;
-			const auto centerIndex = cellIndex(point);
-			result.reserve(cell(centerIndex).size() * 27); // just an estimate
-			for (auto xOff : {-1, 0, 1}) {
-				for (auto yOff : {-1, 0, 1}) {
-					for (auto zOff : {-1, 0, 1}) {
-						const auto index = centerIndex + ivec3{xOff, yOff, zOff};
-						if (index.x < 0 || index.x >= dims.x) continue;
-						if (index.y < 0 || index.y >= dims.y) continue;
-						if (index.z < 0 || index.z >= dims.z) continue;
-						for (auto& p : cell(index))
-							if (length2(p.pos - point) < cellSize * cellSize && std::find(begin(ignore), end(ignore), p.pos) == end(ignore))
-								result.push_back(&p);
-					}
-				}
-			}
-			return result;
+		auto operator[](std::uint32_t e) -> MeshEdge& {
+			return blocks[e >> blockBits][e & (blockSize - 1)];
 		}
 
-		vec3 lower;
-		vec3 upper;
-		float cellSize;
-		ivec3 dims;
-		std::vector<Cell> cells;
+		std::vector<std::unique_ptr<MeshEdge[]>> blocks;
+		std::uint32_t size = 0;
+		std::vector<std::uint32_t> released;
 	};
-	//compute the ball's center via it's connecting face and radius, return its center's position
-	auto computeBallCenter(MeshFace f, float radius) -> std::optional<vec3> {
-		const vec3 ac = f[2]->pos - f[0]->pos;
-		const vec3 ab = f[1]->pos - f[0]->pos;
-		const vec3 abXac = cross(ab, ac);
-		const vec3 toCircumCircleCenter = (cross(abXac, ab) * dot(ac, ac) + cross(ac, abXac) * dot(ab, ab)) / (2 * dot(abXac, abXac));
-		const vec3 circumCircleCenter = f[0]->pos + toCircumCircleCenter;
-
-		const auto heightSquared = radius * radius - dot(toCircumCircleCenter, toCircumCircleCenter);
-		if (heightSquared < 0)
-			return {};
-		auto ballCenter = circumCircleCenter + f.normal() * std::sqrt(heightSquared);
-		return ballCenter;
+	//the pivot result after the BPA, which is the target point and the corresponding ball's center
+	struct PivotResult {
+		std::uint32_t p;
+		vec3 center;
+	};
+	//the mutable state of the points during one reconstruction, indexed by slot: 'used' indicating whether the point has been
+	//used for an iteration of ball, how many active edges the point has, it is on the front while it has one, and how many front
+	//(active and boundary) edges it has. the spatial index itself only holds the point order and positions. 'used' takes a byte
+	//per point rather than a bit of a vector<bool>, so the tiles can write the flags of their own points at the same time
+	struct PointStates {
+		std::vector<std::uint8_t> used;
+		std::vector<std::uint32_t> activeEdges;
+		std::vector<std::uint32_t> frontDegree;
+	};
+
+	auto ReconstructionCounters::operator+=(const ReconstructionCounters& other) -> ReconstructionCounters& {
+		seeds += other.seeds;
+		seedPairs += other.seedPairs;
+		seedBalls += other.seedBalls;
+		seedEmptyBallTests += other.seedEmptyBallTests;
+		pivots += other.pivots;
+		pivotTriangles += other.pivotTriangles;
+		candidates += other.candidates;
+		missed += other.missed;
+		innerEdgeRejections += other.innerEdgeRejections;
+		emptyBallTests += other.emptyBallTests;
+		nonEmptyBalls += other.nonEmptyBalls;
+		batches += other.batches;
+		retries += other.retries;
+		for (std::size_t c = 0; c < glueCases.size(); c++)
+			glueCases[c] += other.glueCases[c];
+		boundaryEdges += other.boundaryEdges;
+		//the fronts of the tiles are never all at their peak at once, the largest of them is kept
+		peakFrontEdges = std::max(peakFrontEdges, other.peakFrontEdges);
+		for (std::size_t b = 0; b < neighborhoodSizes.size(); b++)
+			neighborhoodSizes[b] += other.neighborhoodSizes[b];
+		return *this;
 	}
-	//check whether the current ball doesn't include any points inside it, if so such pivoting way is illegal
-	auto ballIsEmpty(vec3 ballCenter, const std::vector<MeshPoint*>& points, float radius) -> bool {
-		return !std::any_of(begin(points), end(points), [&](MeshPoint* p) {
-			return length2(p->pos - ballCenter) < radius * radius - 1e-4f; // TODO epsilon
-		});
+
+	//adds the work of a seed search to the counters
+	void countSeedSearch(const SeedCounters& search, ReconstructionCounters& counters) {
+		counters.seedPairs += search.pairs;
+		counters.seedBalls += search.balls;
+		counters.seedEmptyBallTests += search.emptinessTests;
 	}
 
-	//returns the first seed result (face and the ball's center), if no trangle is found, it returns null
-	auto findSeedTriangle(Grid& grid, float radius) -> std::optional<SeedResult> {
-		for (auto& cell : grid.cells) {
-			const auto avgNormal = normalize(std::accumulate(begin(cell), end(cell), vec3{}, [](vec3 acc, const MeshPoint& p) {
-				return acc + p.normal;
-			}));
-			for (auto& p1 : cell) {
-				auto neighborhood = grid.sphericalNeighborhood(p1.pos, {p1.pos});
-				std::sort(begin(neighborhood), end(neighborhood), [&](MeshPoint* a, MeshPoint* b) {
-					return length(a->pos - p1.pos) < length(b->pos - p1.pos);
-				});
+	//the bucket of the histogram of neighborhood sizes a neighborhood of count points goes to
+	auto neighborhoodSizeBucket(std::uint32_t count) -> std::size_t {
+		std::size_t bucket = 0;
+		for (; count > 0; count >>= 1)
+			bucket++;
+		return std::min(bucket, ReconstructionCounters{}.neighborhoodSizes.size() - 1);
+	}
 
-				for (auto& p2 : neighborhood) {
-					for (auto& p3 : neighborhood) {
-						if (p2 == p3) continue;
-						MeshFace f{{&p1, p2, p3}};
-						if (dot(f.normal(), avgNormal) < 0) // only accept triangles which's normal points into the same half-space as the average normal of this cell's points
-							continue;
-						const auto ballCenter = computeBallCenter(f, radius);
-						if (ballCenter && ballIsEmpty(ballCenter.value(), neighborhood, radius)) {
-							p1.used = true;
-							p2->used = true;
-							p3->used = true;
-							return SeedResult{f, ballCenter.value()};
-						}
-					}
-				}
-			}
-		}
-		return {};
+	auto secondsSince(std::chrono::steady_clock::time_point start) -> double {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 	}
+
+	//buffers shared by all queries of one reconstruction, so the pivot loop does not allocate once they have grown
+	struct QueryBuffers {
+		std::vector<std::uint32_t> neighborhood;
+		//ten columns of the pivot candidates: their positions and normals, and the kernel's ball centers and keys
+		std::vector<float> pivotColumns;
+		PivotKernel pivot = pivotKernel();
+		AnyWithinRadiusKernel anyWithinRadius = anyWithinRadiusKernel();
+	};
+
+	//the fronts grown over the points in the slots owned: their edges, the stack of edges to pivot, the triangles they made and
+	//the seams, the edges whose pivot reached a point outside owned. the edges are found by their points in hash tables: the front
+	//edges by their directed pair and the inner edges by their undirected pair, so no per point list of edges is kept or scanned.
+	//a reconstruction grows one over all points, or first one per tile in parallel, which are then merged into it
+	struct Fronts {
+		Cell owned;
+		EdgePool edges;
+		EdgeTable<std::uint32_t, noEdge> frontEdges;
+		EdgeTable<bool> innerEdges;
+		std::vector<std::uint32_t> front;
+		std::vector<std::uint32_t> triangles;
+		std::vector<std::uint32_t> seams;
+		QueryBuffers buffers;
+		ReconstructionCounters counters;
+	};
+
 	//from frontiers get one front edge, it will clean this edge in next iteration because it is not front edge any more
-	auto getActiveEdge(std::vector<MeshEdge*>& front) -> std::optional<MeshEdge*> {
+	auto getActiveEdge(Fronts& fronts) -> std::optional<std::uint32_t> {
+		auto& front = fronts.front;
 		while (!front.empty()) {
-			auto* e = front.back();
-			if (e->status == EdgeStatus::active)
+			const auto e = front.back();
+			const auto status = fronts.edges[e].status;
+			if (status == EdgeStatus::active)
 				return e;
 			front.pop_back(); // cleanup non-active edges from front
+			//the front held the last reference to an inner edge, see setStatus
+			if (status == EdgeStatus::inner)
+				fronts.edges.release(e);
 		}
 		return {};
 	}
 
 	
-	//pivoting at one edge, return the target point and the corresponding ball's center. If no point is found, it returns empty 
-	auto ballPivot(const MeshEdge* e, Grid& grid, float radius) -> std::optional<PivotResult> {
-		const auto m = (e->a->pos + e->b->pos) / 2.0f;
-		const auto oldCenterVec = normalize(e->center - m);
-		auto neighborhood = grid.sphericalNeighborhood(m, {e->a->pos, e->b->pos, e->opposite->pos});
-
-		static auto counter = 0;
-		counter++;
-
-		auto smallestAngle = std::numeric_limits<float>::max();
-		MeshPoint* pointWithSmallestAngle = nullptr;
-		vec3 centerOfSmallest{};
-		std::stringstream ss;
-		auto i = 0;
-		int smallestNumber = 0;
-		for (const auto& p : neighborhood) {
-			i++;
-			auto newFaceNormal = Triangle{e->b->pos, e->a->pos, p->pos}.normal();
-
-			// this check is not in the paper: all points' normals must point into the same half-space
-			if (dot(newFaceNormal, p->normal) < 0)
-				continue;
-
-			const auto c = computeBallCenter(MeshFace{{e->b, e->a, p}}, radius);
-			if (!c) {
-				continue;
-			}
-
-			// this check is not in the paper: the ball center must always be above the triangle
-			const auto newCenterVec = normalize(c.value() - m);
-			const auto newCenterFaceDot = dot(newCenterVec, newFaceNormal);
-			if (newCenterFaceDot < 0) {
-				continue;
-			}
+	// this check is not in the paper: points to which we already have an inner edge are not considered
+	auto hasInnerEdge(const EdgeTable<bool>& innerEdges, const MeshEdge& e, std::uint32_t p) -> bool {
+		return innerEdges.contains(undirectedEdgeKey(p, e.a)) || innerEdges.contains(undirectedEdgeKey(p, e.b));
+	}
 
-			// this check is not in the paper: points to which we already have an inner edge are not considered
-			for (const auto* ee : p->edges) {
-				const auto* otherPoint = ee->a == p ? ee->b : ee->a;
-				if (ee->status == EdgeStatus::inner && (otherPoint == e->a || otherPoint == e->b)) {
-					goto nextneighbor;
-				}
-			}
+	//pivoting at one edge, return the target point and the corresponding ball's center. If no point is found, it returns empty 
+	template <typename Index>
+	auto ballPivot(const MeshEdge& e, Index& index, const NeighborLists& lists, const EdgeTable<bool>& innerEdges, float radius, QueryBuffers& buffers,
+		ReconstructionCounters& counters) -> std::optional<PivotResult> {
+		const auto aPos = index.position(e.a);
+		const auto bPos = index.position(e.b);
+		const auto m = (aPos + bPos) / 2.0f;
+		const auto oldCenterVec = normalize(e.center - m);
+		auto& neighborhood = buffers.neighborhood;
+		if (lists.empty())
+			index.sphericalNeighborhood(m, {e.a, e.b, e.opposite}, neighborhood);
+		else
+			lists.around(index, e.a, m, index.queryRadius * index.queryRadius, {e.a, e.b, e.opposite}, neighborhood);
+
+		//gather the candidates in structure-of-arrays layout and let the kernel compute all their balls at once
+		const auto count = static_cast<std::uint32_t>(neighborhood.size());
+		auto& columns = buffers.pivotColumns;
+		columns.resize(std::size_t{count} * 10);
+		const auto column = [&](std::size_t c) { return columns.data() + c * count; };
+		const SoAPivotCandidates candidates{column(0), column(1), column(2), column(3), column(4), column(5)};
+		const SoAPivotBalls balls{column(6), column(7), column(8), column(9)};
+		for (std::uint32_t k = 0; k < count; k++) {
+			const auto pos = index.position(neighborhood[k]);
+			const auto normal = index.normal(neighborhood[k]);
+			column(0)[k] = pos.x;
+			column(1)[k] = pos.y;
+			column(2)[k] = pos.z;
+			column(3)[k] = normal.x;
+			column(4)[k] = normal.y;
+			column(5)[k] = normal.z;
+		}
+		auto best = buffers.pivot(PivotEdge{aPos, bPos, m, oldCenterVec, radius}, candidates, count, balls);
+		if constexpr (counting) {
+			counters.pivots++;
+			counters.candidates += count;
+			counters.neighborhoodSizes[neighborhoodSizeBucket(count)]++;
+		}
 
-			{
-				auto angle = std::acos(std::clamp(dot(oldCenterVec, newCenterVec), -1.0f, 1.0f));
-				if (dot(cross(newCenterVec, oldCenterVec), e->a->pos - e->b->pos) < 0)
-					angle += M_PI;
-				if (angle < smallestAngle) {
-					smallestAngle = angle;
-					pointWithSmallestAngle = p;
-					centerOfSmallest = c.value();
-					smallestNumber = i;
-				}
-			}
-		nextneighbor:;
+		while (best < count && hasInnerEdge(innerEdges, e, neighborhood[best])) {
+			balls.key[best] = std::numeric_limits<float>::infinity();
+			best = smallestKey(balls.key, count);
+			if constexpr (counting)
+				counters.innerEdgeRejections++;
 		}
 
-		if (smallestAngle != std::numeric_limits<float>::max()) {
-			if (ballIsEmpty(centerOfSmallest, neighborhood, radius)) {
-				return PivotResult{pointWithSmallestAngle, centerOfSmallest};
+		if (best < count) {
+			const vec3 centerOfSmallest{balls.x[best], balls.y[best], balls.z[best]};
+			if constexpr (counting)
+				counters.emptyBallTests++;
+			if (ballIsEmpty(centerOfSmallest, {candidates.x, candidates.y, candidates.z}, count, radius, buffers.anyWithinRadius)) {
+				return PivotResult{neighborhood[best], centerOfSmallest};
 			}
+			if constexpr (counting)
+				counters.nonEmptyBalls++;
+		} else if constexpr (counting) {
+			counters.missed++;
 		}
 
 		return {};
 	}
 
-	auto notUsed(const MeshPoint* p) -> bool {
-		return !p->used;
+	auto notUsed(const PointStates& states, std::uint32_t p) -> bool {
+		return !states.used[p];
 	}
 
-	auto onFront(const MeshPoint* p) -> bool {
-		return std::any_of(begin(p->edges), end(p->edges), [&](const MeshEdge* e) {
-			return e->status == EdgeStatus::active;
-		});
+	auto onFront(const PointStates& states, std::uint32_t p) -> bool {
+		return states.activeEdges[p] > 0;
 	}
 
-	void remove(MeshEdge* edge) {
+	//registers a new active edge with its points and the front
+	void add(std::uint32_t e, Fronts& fronts, PointStates& states) {
+		const auto& edge = fronts.edges[e];
+		states.activeEdges[edge.a]++;
+		states.activeEdges[edge.b]++;
+		states.frontDegree[edge.a]++;
+		states.frontDegree[edge.b]++;
+		fronts.frontEdges.insert(edgeKey(edge.a, edge.b), e);
+		if constexpr (counting)
+			fronts.counters.peakFrontEdges = std::max<std::uint64_t>(fronts.counters.peakFrontEdges, fronts.frontEdges.size);
+	}
+
+	//every status change goes through here, so the active edge counts and the edge tables stay in step with the edges
+	void setStatus(std::uint32_t e, EdgeStatus status, Fronts& fronts, PointStates& states) {
+		auto& edges = fronts.edges;
+		auto& edge = edges[e];
+		if (edge.status == EdgeStatus::active) {
+			states.activeEdges[edge.a]--;
+			states.activeEdges[edge.b]--;
+		}
+		if (status == EdgeStatus::active && edge.status != EdgeStatus::active) {
+			states.activeEdges[edge.a]++;
+			states.activeEdges[edge.b]++;
+		}
+		if (status == EdgeStatus::inner) {
+			states.frontDegree[edge.a]--;
+			states.frontDegree[edge.b]--;
+			fronts.frontEdges.erase(edgeKey(edge.a, edge.b), e);
+			//an inner pair is only looked up between a point of an active edge and a candidate, so the pairs of two points
+			//without front edges are never asked for again. they are dropped before the table grows, which keeps it to the
+			//pairs around the front
+			if (fronts.innerEdges.full()) {
+				fronts.innerEdges.prune([&](std::uint64_t key, bool) {
+					return states.frontDegree[key >> 32] == 0 && states.frontDegree[key & 0xffffffffu] == 0;
+				});
+			}
+			fronts.innerEdges.insert(undirectedEdgeKey(edge.a, edge.b), true);
+			//the other edges no longer refer to an inner edge, but the front or the seams may still name it, so its slot is only
+			//reused once they are done with it. an active edge is on the front once, which releases it when it drops it, or it
+			//is taken off for a batch, which releases it. a boundary edge is not on the front and is released here, unless the
+			//seams of a tile may name it: those are released when the tile is merged
+			if (edge.status == EdgeStatus::boundary && fronts.seams.empty())
+				edges.release(e);
+		}
+		edge.status = status;
+	}
+
+	void remove(std::uint32_t e, Fronts& fronts, PointStates& states) {
 		// just mark the edge as inner. The edge will be removed later in getActiveEdge()
-		edge->status = EdgeStatus::inner;
+		setStatus(e, EdgeStatus::inner, fronts, states);
 	}
 
-	void outputTriangle(MeshFace f, std::vector<Triangle>& triangles) {
-		triangles.push_back({f[0]->pos, f[1]->pos, f[2]->pos});
+	template <typename Index>
+	void outputTriangle(const Index& index, MeshFace f, std::vector<std::uint32_t>& triangles) {
+		for (const auto p : f)
+			triangles.push_back(index.inputIndex(p));
 	}
 
-	auto join(MeshEdge* e_ij, MeshPoint* o_k, vec3 o_k_ballCenter, std::vector<MeshEdge*>& front, std::deque<MeshEdge>& edges) -> std::tuple<MeshEdge*, MeshEdge*> {
-		auto& e_ik = edges.emplace_back(MeshEdge{e_ij->a, o_k, e_ij->b, o_k_ballCenter});
-		auto& e_kj = edges.emplace_back(MeshEdge{o_k, e_ij->b, e_ij->a, o_k_ballCenter});
+	auto join(std::uint32_t e_ij, std::uint32_t o_k, vec3 o_k_ballCenter, Fronts& fronts, PointStates& states) -> std::tuple<std::uint32_t, std::uint32_t> {
+		//the pool may grow, so the edges are only referred to by index across the additions
+		auto& edges = fronts.edges;
+		const auto i = edges[e_ij].a;
+		const auto j = edges[e_ij].b;
+		const auto prev = edges[e_ij].prev;
+		const auto next = edges[e_ij].next;
+		const auto e_ik = edges.add(MeshEdge{i, o_k, j, EdgeStatus::active, o_k_ballCenter, prev, noEdge});
+		const auto e_kj = edges.add(MeshEdge{o_k, j, i, EdgeStatus::active, o_k_ballCenter, e_ik, next});
 
-		e_ik.next = &e_kj;
-		e_ik.prev = e_ij->prev;
-		e_ij->prev->next = &e_ik;
-		e_ij->a->edges.push_back(&e_ik);
+		edges[e_ik].next = e_kj;
+		edges[prev].next = e_ik;
+		add(e_ik, fronts, states);
 
-		e_kj.prev = &e_ik;
-		e_kj.next = e_ij->next;
-		e_ij->next->prev = &e_kj;
-		e_ij->b->edges.push_back(&e_kj);
+		edges[next].prev = e_kj;
+		add(e_kj, fronts, states);
 
-		o_k->used = true;
-		o_k->edges.push_back(&e_ik);
-		o_k->edges.push_back(&e_kj);
+		states.used[o_k] = true;
 
-		front.push_back(&e_ik);
-		front.push_back(&e_kj);
-		remove(e_ij);
+		fronts.front.push_back(e_ik);
+		fronts.front.push_back(e_kj);
+		remove(e_ij, fronts, states);
 
-		return {&e_ik, &e_kj};
+		return {e_ik, e_kj};
 	}
 	//if two edges are actually the same, this function will merge them together
-	void glue(MeshEdge* a, MeshEdge* b, std::vector<MeshEdge*>& front) {
+	void glue(std::uint32_t a, std::uint32_t b, Fronts& fronts, PointStates& states) {
+		auto& edges = fronts.edges;
+		auto& ea = edges[a];
+		auto& eb = edges[b];
 
 		// case 1
-		if (a->next == b && a->prev == b && b->next == a && b->prev == a) {
-			remove(a);
-			remove(b);
+		if (ea.next == b && ea.prev == b && eb.next == a && eb.prev == a) {
+			if constexpr (counting)
+				fronts.counters.glueCases[0]++;
+			remove(a, fronts, states);
+			remove(b, fronts, states);
 			return;
 		}
 		// case 2
-		if (a->next == b && b->prev == a) {
-			a->prev->next = b->next;
-			b->next->prev = a->prev;
-			remove(a);
-			remove(b);
+		if (ea.next == b && eb.prev == a) {
+			if constexpr (counting)
+				fronts.counters.glueCases[1]++;
+			edges[ea.prev].next = eb.next;
+			edges[eb.next].prev = ea.prev;
+			remove(a, fronts, states);
+			remove(b, fronts, states);
 			return;
 		}
-		if (a->prev == b && b->next == a) {
-			a->next->prev = b->prev;
-			b->prev->next = a->next;
-			remove(a);
-			remove(b);
+		if (ea.prev == b && eb.next == a) {
+			if constexpr (counting)
+				fronts.counters.glueCases[1]++;
+			edges[ea.next].prev = eb.prev;
+			edges[eb.prev].next = ea.next;
+			remove(a, fronts, states);
+			remove(b, fronts, states);
 			return;
 		}
-		// case 3/4
-		a->prev->next = b->next;
-		b->next->prev = a->prev;
-		a->next->prev = b->prev;
-		b->prev->next = a->next;
-		remove(a);
-		remove(b);
+		// case 3/4: the edges split their loop in two if they are on the same one, else they join two loops into one. only
+		// counting tells them apart, by walking the loop of a until it comes back or reaches b
+		if constexpr (counting) {
+			auto e = ea.next;
+			while (e != a && e != b)
+				e = edges[e].next;
+			fronts.counters.glueCases[e == b ? 2 : 3]++;
+		}
+		edges[ea.prev].next = eb.next;
+		edges[eb.next].prev = ea.prev;
+		edges[ea.next].prev = eb.prev;
+		edges[eb.prev].next = ea.next;
+		remove(a, fronts, states);
+		remove(b, fronts, states);
 	}
 
-	auto findReverseEdgeOnFront(MeshEdge* edge) -> MeshEdge* {
-		for (auto& e : edge->a->edges)
-			if (e->a == edge->b)
-				return e;
-		return nullptr;
+	auto findReverseEdgeOnFront(std::uint32_t e, Fronts& fronts) -> std::uint32_t {
+		return fronts.frontEdges.find(edgeKey(fronts.edges[e].b, fronts.edges[e].a));
 	}
 	
 	//reconstructing the entire point cloud, gives faces as output
 	auto reconstruct(const std::vector<Point>& points, float radius) -> std::vector<Triangle> {
-		//construct grid spaces
-		Grid grid(points, radius);
-		//get the initial starting face
-		const auto seedResult = findSeedTriangle(grid, radius);
-		//if no face is found, the algorthm terminates
-		if (!seedResult) {
-			std::cerr << "No seed triangle found, perhaps the radius is too small!!!\n";
-			return {};
-		}
-		//generate face set and edge set
-		std::vector<Triangle> triangles;
-		std::deque<MeshEdge> edges;
+		return reconstruct(points, radius, ReconstructionOptions{});
+	}
+
+	//whether the face (a, p, b) of the pivot of the edge a->b to p clashes with a face of the front: a front edge a->p or p->b
+	//already carries a face in the orientation the new face would give it, or the face already exists the other way round, as
+	//(b, p, a) on the front edges b->p and p->a. a front edge the other way round without that face is no clash, it is glued
+	//to the new edge and closes a hole. the edges with two faces are inner edges, which the pivot already rejects.
+	//the boundary edges next to a face are not inner edges, so a pivot can close onto its back. this happens now and then in
+	//one front, more often at the seams of tiles and around the boundary edges a later pass reactivates
+	auto clashesWithFront(std::uint32_t e, std::uint32_t p, Fronts& fronts) -> bool {
+		const auto a = fronts.edges[e].a;
+		const auto b = fronts.edges[e].b;
+		const auto carries = [&](std::uint32_t from, std::uint32_t to, std::uint32_t opposite) {
+			const auto f = fronts.frontEdges.find(edgeKey(from, to));
+			return f != noEdge && (opposite == noPoint || fronts.edges[f].opposite == opposite);
+		};
+		return carries(a, p, noPoint) || carries(p, b, noPoint) || carries(b, p, a) || carries(p, a, b);
+	}
+
+	//sets up the seed face as a new front of three active edges
+	template <typename Index>
+	void startFront(const SeedResult& seedResult, const Index& index, Fronts& fronts, PointStates& states) {
 		//seed is the three points of the initial face
 		//set up this face and its points and edges
-		auto [seed, ballCenter] = seedResult.value();
-		outputTriangle(seed, triangles);
-		auto& e0 = edges.emplace_back(MeshEdge{seed[0], seed[1], seed[2], ballCenter});
-		auto& e1 = edges.emplace_back(MeshEdge{seed[1], seed[2], seed[0], ballCenter});
-		auto& e2 = edges.emplace_back(MeshEdge{seed[2], seed[0], seed[1], ballCenter});
-		e0.prev = e1.next = &e2;
-		e0.next = e2.prev = &e1;
-		e1.prev = e2.next = &e0;
-		seed[0]->edges = { &e0, &e2 };
-		seed[1]->edges = { &e0, &e1 };
-		seed[2]->edges = { &e1, &e2 };
+		auto& edges = fronts.edges;
+		auto [seed, ballCenter] = seedResult;
+		outputTriangle(index, seed, fronts.triangles);
+		const auto e0 = edges.add(MeshEdge{seed[0], seed[1], seed[2], EdgeStatus::active, ballCenter, noEdge, noEdge});
+		const auto e1 = edges.add(MeshEdge{seed[1], seed[2], seed[0], EdgeStatus::active, ballCenter, noEdge, noEdge});
+		const auto e2 = edges.add(MeshEdge{seed[2], seed[0], seed[1], EdgeStatus::active, ballCenter, noEdge, noEdge});
+		edges[e0].prev = edges[e1].next = e2;
+		edges[e0].next = edges[e2].prev = e1;
+		edges[e1].prev = edges[e2].next = e0;
+		//the edge counts are only allocated once there are edges
+		if (states.activeEdges.empty()) {
+			states.activeEdges.resize(states.used.size());
+			states.frontDegree.resize(states.used.size());
+		}
+		add(e0, fronts, states);
+		add(e1, fronts, states);
+		add(e2, fronts, states);
 		//add three intial edges as three members of the frontier
-		std::vector<MeshEdge*> front{&e0, &e1, &e2};
-		//BPA iterations:
-		while (auto e_ij = getActiveEdge(front)) {
+		fronts.front = {e0, e1, e2};
+	}
+
+	//applies the pivot of the active edge e_ij to the fronts, returns whether it made a triangle. a pivot reaching a point the
+	//fronts do not own makes a boundary edge, which is kept as a seam for the stitching
+	template <typename Index>
+	auto commitPivot(std::uint32_t e_ij, const std::optional<PivotResult>& o_k, const Index& index, Fronts& fronts, PointStates& states) -> bool {
+		if (o_k && !fronts.owned.contains(o_k->p)) {
+			setStatus(e_ij, EdgeStatus::boundary, fronts, states);
+			fronts.seams.push_back(e_ij);
+			return false;
+		}
+		//such point must (1.exist 2.not used or has at least one of its edges on front, indicating that edge can be used in pivoting)
+		if (o_k && (notUsed(states, o_k->p) || onFront(states, o_k->p)) && !clashesWithFront(e_ij, o_k->p, fronts)) {
+			//add such face in the result 
+			outputTriangle(index, {{fronts.edges[e_ij].a, o_k->p, fronts.edges[e_ij].b}}, fronts.triangles);
+			//merge extra edges if needed
+			if constexpr (counting)
+				fronts.counters.pivotTriangles++;
+			auto [e_ik, e_kj] = join(e_ij, o_k->p, o_k->center, fronts, states);
+			if (const auto e_ki = findReverseEdgeOnFront(e_ik, fronts); e_ki != noEdge) glue(e_ik, e_ki, fronts, states);
+			if (const auto e_jk = findReverseEdgeOnFront(e_kj, fronts); e_jk != noEdge) glue(e_kj, e_jk, fronts, states);
+			return true;
+		}
+		setStatus(e_ij, EdgeStatus::boundary, fronts, states);
+		return false;
+	}
+
+	//BPA iterations: pivots the active edges until none is left
+	template <typename Index>
+	void growFront(Index& index, const NeighborLists& lists, float radius, Fronts& fronts, PointStates& states) {
+		while (auto e_ij = getActiveEdge(fronts)) {
 			//get the target point via BPA
-			const auto o_k = ballPivot(e_ij.value(), grid, radius);
-			//such point must (1.exist 2.not used or has at least one of its edges on front, indicating that edge can be used in pivoting)
-			if (o_k && (notUsed(o_k->p) || onFront(o_k->p))) {
-				//add such face in the result 
-				outputTriangle({{e_ij.value()->a, o_k->p, e_ij.value()->b}}, triangles);
-				//merge extra edges if needed
-				auto [e_ik, e_kj] = join(e_ij.value(), o_k->p, o_k->center, front, edges);
-				if (auto* e_ki = findReverseEdgeOnFront(e_ik)) glue(e_ik, e_ki, front);
-				if (auto* e_jk = findReverseEdgeOnFront(e_kj)) glue(e_kj, e_jk, front);
+			const auto o_k = ballPivot(fronts.edges[e_ij.value()], index, lists, fronts.innerEdges, radius, fronts.buffers, fronts.counters);
+			commitPivot(e_ij.value(), o_k, index, fronts, states);
+		}
+	}
+
+	//an active edge pivoted ahead of its commit: its index, the edge as it was and the result of its pivot
+	struct BatchedPivot {
+		std::uint32_t e;
+		MeshEdge edge;
+		std::optional<PivotResult> result;
+	};
+
+	//the edges pivoted at the same time, and the buffers and counters of the tasks pivoting them
+	struct PivotBatch {
+		//how many edges of the front are looked at for one batch, per edge in it
+		static constexpr std::size_t lookahead = 4;
+
+		std::size_t size = 0;
+		std::vector<BatchedPivot> pivots;
+		std::vector<QueryBuffers> buffers;
+		std::vector<ReconstructionCounters> counters;
+		//the points of the edges in the batch, keyed by the point alone
+		EdgeTable<bool> points;
+		//active edges passed over for the batch, they go back on the front
+		std::vector<std::uint32_t> deferred;
+		//the points of the triangles committed so far in the batch
+		std::vector<std::uint32_t> touched;
+	};
+
+	//the BPA iterations of growFront, but up to batch.size active edges are taken off the front at once and pivoted in parallel.
+	//a pivot only reads the edge, the positions and the inner edges, so the pivots run without locks and are committed in their
+	//order afterwards. a commit only adds inner edges between the points of its triangle, so an earlier commit of the batch
+	//makes a pivot stale if its point now has an inner edge to the pivoted edge, or, if it found no point, if the edge shares a
+	//point with an earlier triangle. stale pivots go back on the front and are pivoted again, all others are committed exactly
+	//as if they were pivoted at their commit.
+	//a commit only glues away front edges sharing a point with its edge, so the edges of a batch share no points: edges next
+	//to one already taken are passed over and stay on the front. an edge glued away anyway is dropped. the edges of a batch are
+	//off the front, so the batch releases those which end up inner
+	template <typename Index>
+	void growFrontBatched(Index& index, const NeighborLists& lists, float radius, Fronts& fronts, PointStates& states, PivotBatch& batch, ThreadPool& pool) {
+		auto& edges = fronts.edges;
+		auto& pivots = batch.pivots;
+		while (getActiveEdge(fronts)) {
+			pivots.clear();
+			batch.points.clear();
+			for (std::size_t looked = 0; pivots.size() < batch.size && looked < batch.size * PivotBatch::lookahead; looked++) {
+				const auto e = getActiveEdge(fronts);
+				if (!e)
+					break;
+				fronts.front.pop_back();
+				const auto& edge = edges[e.value()];
+				if (batch.points.contains(edge.a) || batch.points.contains(edge.b)) {
+					batch.deferred.push_back(e.value());
+					continue;
+				}
+				batch.points.insert(edge.a, true);
+				batch.points.insert(edge.b, true);
+				pivots.push_back({e.value(), edge, {}});
+			}
+			fronts.front.insert(end(fronts.front), rbegin(batch.deferred), rend(batch.deferred));
+			batch.deferred.clear();
+			if constexpr (counting)
+				fronts.counters.batches++;
+			//a task pivots a run of the edges with buffers of its own
+			const auto tasks = std::min(batch.buffers.size(), pivots.size());
+			const auto perTask = (pivots.size() + tasks - 1) / tasks;
+			pool.parallelFor(tasks, [&](std::size_t t) {
+				for (auto i = t * perTask; i < std::min(pivots.size(), (t + 1) * perTask); i++)
+					pivots[i].result = ballPivot(pivots[i].edge, index, lists, fronts.innerEdges, radius, batch.buffers[t], batch.counters[t]);
+			});
+			batch.touched.clear();
+			for (const auto& pivot : pivots) {
+				if (edges[pivot.e].status != EdgeStatus::active) {
+					edges.release(pivot.e);
+					continue;
+				}
+				const auto stale = pivot.result
+					? hasInnerEdge(fronts.innerEdges, pivot.edge, pivot.result->p)
+					: std::find_if(begin(batch.touched), end(batch.touched), [&](std::uint32_t p) { return p == pivot.edge.a || p == pivot.edge.b; }) != end(batch.touched);
+				if (stale) {
+					fronts.front.push_back(pivot.e);
+					if constexpr (counting)
+						fronts.counters.retries++;
+					continue;
+				}
+				if (commitPivot(pivot.e, pivot.result, index, fronts, states)) {
+					batch.touched.insert(end(batch.touched), {pivot.edge.a, pivot.edge.b, pivot.result->p});
+					edges.release(pivot.e);
+				}
+			}
+		}
+		if constexpr (counting) {
+			for (auto& counters : batch.counters) {
+				fronts.counters += counters;
+				counters = {};
+			}
+		}
+	}
+
+	//a tile owns a run of slots and searches its seeds in the cells [firstCell, lastCell) holding them
+	struct Tile {
+		Cell owned;
+		std::uint32_t firstCell;
+		std::uint32_t lastCell;
+	};
+
+	//splits the slots into count runs of about the same number of points. a run of slots is a slab of the grid in linear cell
+	//order and a compact block of cells in Morton order or in the leaf order of the trees
+	template <typename Index>
+	auto splitIntoTiles(const Index& index, unsigned count) -> std::vector<Tile> {
+		//the first cell ending after slot
+		const auto cellAfter = [&](std::uint32_t slot) {
+			std::uint32_t low = 0;
+			auto high = index.cellCount();
+			while (low < high) {
+				const auto middle = low + (high - low) / 2;
+				if (index.cell(middle).last <= slot)
+					low = middle + 1;
+				else
+					high = middle;
+			}
+			return low;
+		};
+		std::vector<Tile> tiles;
+		std::uint32_t first = 0;
+		for (unsigned t = 1; t <= count; t++) {
+			const auto last = t == count ? index.size() : static_cast<std::uint32_t>(std::uint64_t{index.size()} * t / count);
+			if (last > first) {
+				tiles.push_back({{first, last}, cellAfter(first), cellAfter(last - 1) + 1});
+				first = last;
+			}
+		}
+		return tiles;
+	}
+
+	//moves the fronts of a tile into the merged ones: its edges are appended behind the merged edges and keep their links,
+	//its inner edges are released, also those kept for its seams, the edge tables, triangles, seams and counters are added
+	void merge(Fronts& tile, Fronts& merged) {
+		const auto offset = merged.edges.size;
+		const auto shifted = [&](std::uint32_t e) { return e == noEdge ? noEdge : e + offset; };
+		for (std::uint32_t e = 0; e < tile.edges.size; e++) {
+			auto edge = tile.edges[e];
+			edge.prev = shifted(edge.prev);
+			edge.next = shifted(edge.next);
+			merged.edges.append(edge);
+			//the released slots of the tile are not carried over, every inner edge is released anew
+			if (edge.status == EdgeStatus::inner)
+				merged.edges.release(e + offset);
+			else
+				merged.frontEdges.insert(edgeKey(edge.a, edge.b), e + offset);
+		}
+		for (const auto& entry : tile.innerEdges.entries)
+			if (entry.key != decltype(tile.innerEdges)::emptyKey)
+				merged.innerEdges.insert(entry.key, entry.value);
+		merged.triangles.insert(end(merged.triangles), begin(tile.triangles), end(tile.triangles));
+		for (const auto e : tile.seams)
+			merged.seams.push_back(shifted(e));
+		merged.counters += tile.counters;
+		if constexpr (counting)
+			merged.counters.peakFrontEdges = std::max<std::uint64_t>(merged.counters.peakFrontEdges, merged.frontEdges.size);
+		//the tile is done, its memory is freed
+		tile.edges.blocks.clear();
+		tile.edges.released.clear();
+		tile.edges.size = 0;
+		tile.frontEdges.release();
+		tile.innerEdges.release();
+		std::vector<std::uint32_t>().swap(tile.front);
+		std::vector<std::uint32_t>().swap(tile.triangles);
+		std::vector<std::uint32_t>().swap(tile.seams);
+	}
+
+	//where the seed search of a tile goes on
+	struct TileSeedSearch {
+		SeedCursor cursor;
+		SeedBuffers buffers;
+		SeedCounters counters;
+	};
+
+	//grows the fronts of every tile on the pool, each only over the points it owns, and merges them into fronts. the seams
+	//of the tiles are put back on the front, so growing it stitches the tiles together. a seam may have been glued in its
+	//tile since, its slot is kept while the seams name it, so only the edges still on the boundary are reactivated.
+	//every connected component is a task of its own: a task searches the next seed of its tile, grows its front and spawns
+	//the task of the tile's next component. the components differ a lot in size, the work stealing of the pool keeps the
+	//threads busy with the tiles of others meanwhile. the components of one tile share its fronts and its seed cursor, so they
+	//stay a chain of tasks and a large component holds up the rest of its tile, only the tiles are balanced. a task runs on a thread of the pool, so it pivots one edge after the
+	//other, never in batches. returns what the workers did
+	template <typename Index>
+	auto growTiles(Index& index, const NeighborLists& lists, float radius, unsigned count, ThreadPool& pool, Fronts& fronts, PointStates& states) -> std::vector<WorkerStatistics> {
+		const auto tiles = splitIntoTiles(index, count);
+		std::vector<Fronts> tileFronts(tiles.size());
+		std::vector<TileSeedSearch> searches(tiles.size());
+		for (std::size_t t = 0; t < tiles.size(); t++) {
+			tileFronts[t].owned = tiles[t].owned;
+			searches[t].cursor = SeedCursor{tiles[t].firstCell};
+		}
+		//the workers write the edge counts of their own points only, so they are allocated before
+		states.activeEdges.resize(index.size());
+		states.frontDegree.resize(index.size());
+		const auto workers = pool.runTasks(tiles.size(), [&](std::size_t t, const std::function<void(std::size_t)>& spawn) {
+			const auto& tile = tiles[t];
+			auto& own = tileFronts[t];
+			auto& search = searches[t];
+			if (const auto seedResult = findSeedInCells<counting>(index, lists, states.used, tile.owned, radius, search.buffers, search.cursor, tile.lastCell, search.counters)) {
+				for (const auto p : seedResult->f)
+					states.used[p] = true;
+				if constexpr (counting)
+					own.counters.seeds++;
+				startFront(seedResult.value(), index, own, states);
+				growFront(index, lists, radius, own, states);
+				spawn(t);
 			} else {
-				e_ij.value()->status = EdgeStatus::boundary;
+				if constexpr (counting)
+					countSeedSearch(search.counters, own.counters);
+				search = {};
+			}
+		});
+		for (auto& own : tileFronts)
+			merge(own, fronts);
+		for (const auto e : fronts.seams) {
+			if (fronts.edges[e].status == EdgeStatus::boundary) {
+				setStatus(e, EdgeStatus::active, fronts, states);
+				fronts.front.push_back(e);
 			}
 		}
+		fronts.seams.clear();
+		return workers;
+	}
+
+	//a later pass of a larger radius: the boundary edges the smaller radii left all go back on the front. if the ball of the new
+	//radius on their face is empty, their center moves to that ball and the pivot starts from it, as in the paper. the paper
+	//leaves the other edges on the boundary, here their pivot starts from the ball of the smaller radius: a face is still only
+	//made with an empty ball of the new radius. on the bunny a seventh of the edges 0.001 leaves have no empty ball of 0.002
+	//on their face, pivoting them too leaves 843 border edges after 0.001 and 0.002 instead of 1488
+	template <typename Index>
+	void reactivateBoundaryEdges(Index& index, float radius, Fronts& fronts, PointStates& states) {
+		auto& buffers = fronts.buffers;
+		for (std::uint32_t e = 0; e < fronts.edges.size; e++) {
+			auto& edge = fronts.edges[e];
+			if (edge.status != EdgeStatus::boundary)
+				continue;
+			//the face of the edge, in the orientation it was output with
+			if (const auto center = computeBallCenter(triangle(index, {{edge.a, edge.b, edge.opposite}}), radius)) {
+				if constexpr (counting)
+					fronts.counters.emptyBallTests++;
+				auto& neighborhood = buffers.neighborhood;
+				index.sphericalNeighborhood(center.value(), {edge.a, edge.b, edge.opposite}, neighborhood);
+				const auto count = static_cast<std::uint32_t>(neighborhood.size());
+				auto& columns = buffers.pivotColumns;
+				columns.resize(std::size_t{count} * 3);
+				for (std::uint32_t k = 0; k < count; k++) {
+					const auto pos = index.position(neighborhood[k]);
+					columns[k] = pos.x;
+					columns[count + k] = pos.y;
+					columns[2 * count + k] = pos.z;
+				}
+				if (ballIsEmpty(center.value(), {columns.data(), columns.data() + count, columns.data() + 2 * count}, count, radius, buffers.anyWithinRadius))
+					edge.center = center.value();
+			}
+			setStatus(e, EdgeStatus::active, fronts, states);
+			fronts.front.push_back(e);
+		}
+	}
+
+	//the reconstruction on a ready spatial index, a Grid, KdTree or Octree, built for the first of the increasing radii. the times
+	//and counters go to stats
+	template <typename Index>
+	auto reconstructWith(Index& index, const std::vector<float>& radii, const ReconstructionOptions& options, ReconstructionStats& stats) -> std::vector<std::uint32_t> {
+		ThreadPool pool(options.threads);
+		NeighborLists lists;
+		PointStates states;
+		states.used.resize(index.size());
+		//generate face set and edge set
+		Fronts fronts;
+		fronts.owned = {0, index.size()};
+		//a closed surface over n points has about 2n triangles, reserving them saves the copies of a growing result
+		fronts.triangles.reserve(6 * std::size_t{index.size()});
+		//the fronts grow one pivot after the other, or in batches of pivots computed in parallel
+		PivotBatch batch;
+		batch.size = options.pivotBatch;
+		batch.buffers.resize(4 * std::size_t{pool.size()});
+		batch.counters.resize(batch.buffers.size());
+		for (std::size_t pass = 0; pass < radii.size(); pass++) {
+			const auto radius = radii[pass];
+			if (pass > 0) {
+				const auto start = std::chrono::steady_clock::now();
+				index.setRadius(radius);
+				reactivateBoundaryEdges(index, radius, fronts, states);
+				stats.pivotSeconds += secondsSince(start);
+			}
+			//optionally precompute the neighbors of all points in parallel, index queries are the fallback if they need too much memory
+			if (options.neighborSearch == NeighborSearch::precomputed) {
+				const auto start = std::chrono::steady_clock::now();
+				lists = NeighborLists{};
+				if (!lists.build(index, pool, options.neighborListMemoryLimit))
+					stats.neighborListFallback = true;
+				stats.neighborListSeconds += secondsSince(start);
+			}
+			const auto grow = [&] {
+				const auto start = std::chrono::steady_clock::now();
+				if (batch.size > 1)
+					growFrontBatched(index, lists, radius, fronts, states, batch, pool);
+				else
+					growFront(index, lists, radius, fronts, states);
+				stats.pivotSeconds += secondsSince(start);
+			};
+			//with tiles, most of the surface grows in parallel and the seams between the tiles are closed by grow. in a later pass
+			//grow pivots the reactivated boundary edges
+			if (pass == 0 && options.tiles > 1) {
+				const auto start = std::chrono::steady_clock::now();
+				stats.workers = growTiles(index, lists, radius, options.tiles, pool, fronts, states);
+				stats.tileSeconds += secondsSince(start);
+			}
+			grow();
+			//every seed starts a connected component of its own, the seed search goes on where the previous one stopped
+			//until no three unused points are left to form one
+			SeedSearch search;
+			for (;;) {
+				const auto start = std::chrono::steady_clock::now();
+				const auto seedResult = findSeedTriangle(index, lists, states.used, radius, search, pool);
+				stats.seedSeconds += secondsSince(start);
+				if (!seedResult)
+					break;
+				if constexpr (counting)
+					fronts.counters.seeds++;
+				startFront(seedResult.value(), index, fronts, states);
+				grow();
+			}
+			if constexpr (counting)
+				countSeedSearch(search.counters, fronts.counters);
+		}
+		if constexpr (counting) {
+			for (std::uint32_t e = 0; e < fronts.edges.size; e++)
+				if (fronts.edges[e].status == EdgeStatus::boundary)
+					fronts.counters.boundaryEdges++;
+		}
+		stats.counted = counting;
+		stats.counters = fronts.counters;
+		//if no face is found, the algorthm terminates
+		if (fronts.triangles.empty())
+			std::cerr << "No seed triangle found, perhaps the radius is too small!!!\n";
+		return std::move(fronts.triangles);
+	}
+
+	auto reconstruct(const std::vector<Point>& points, float radius, const ReconstructionOptions& options) -> std::vector<Triangle> {
+		return reconstruct(points, std::vector<float>{radius}, options);
+	}
+
+	auto reconstruct(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options) -> std::vector<Triangle> {
+		ReconstructionStats stats;
+		return reconstruct(points, radii, options, stats);
+	}
+
+	auto reconstruct(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options, ReconstructionStats& stats) -> std::vector<Triangle> {
+		const auto indices = reconstructIndexed(points, radii, options, stats);
+		std::vector<Triangle> triangles;
+		triangles.reserve(indices.size() / 3);
+		for (std::size_t i = 0; i < indices.size(); i += 3)
+			triangles.push_back({points[indices[i]].pos, points[indices[i + 1]].pos, points[indices[i + 2]].pos});
 		return triangles;
 	}
+
+	auto reconstructIndexed(const std::vector<Point>& points, float radius) -> std::vector<std::uint32_t> {
+		return reconstructIndexed(points, radius, ReconstructionOptions{});
+	}
+
+	auto reconstructIndexed(const std::vector<Point>& points, float radius, const ReconstructionOptions& options) -> std::vector<std::uint32_t> {
+		return reconstructIndexed(points, std::vector<float>{radius}, options);
+	}
+
+	auto reconstructIndexed(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options) -> std::vector<std::uint32_t> {
+		ReconstructionStats stats;
+		return reconstructIndexed(points, radii, options, stats);
+	}
+
+	auto reconstructIndexed(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options, ReconstructionStats& stats)
+		-> std::vector<std::uint32_t> {
+		stats = {};
+		if (points.empty())
+			return {};
+		if (points.size() >= maxPoints) {
+			std::cerr << "Too many points, at most 2^30 are supported!!!\n";
+			return {};
+		}
+		if (radii.empty() || !(radii.front() > 0) || std::adjacent_find(begin(radii), end(radii), std::greater_equal<float>()) != end(radii)) {
+			std::cerr << "The radii have to be positive and increasing!!!\n";
+			return {};
+		}
+		//the index is built for the smallest radius, the later passes widen its queries
+		const auto radius = radii.front();
+		const auto start = std::chrono::steady_clock::now();
+		const auto reconstructOn = [&](auto& index) {
+			stats.indexSeconds = secondsSince(start);
+			auto triangles = reconstructWith(index, radii, options, stats);
+			stats.totalSeconds = secondsSince(start);
+			return triangles;
+		};
+		switch (options.spatialIndex) {
+			case SpatialIndexType::kdTree: {
+				KdTree tree(points, radius);
+				return reconstructOn(tree);
+			}
+			case SpatialIndexType::octree: {
+				Octree tree(points, radius);
+				return reconstructOn(tree);
+			}
+			default: {
+				//construct grid spaces
+				Grid grid(points, radius, options.cellOrder, options.gridBackend, options.gridResolution);
+				if (grid.truncated) {
+					std::cerr << "The points span too many grid cells, perhaps the radius is too small!!!\n";
+					return {};
+				}
+				return reconstructOn(grid);
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -20,18 +22,174 @@ namespace BPA {
 	};
 
 
+	//order of the grid cells (and the points inside them) in memory
+	enum class CellOrder {
+		linear, //cells in z-y-x order, points inside a cell in input order
+		morton  //cells and points along a Morton (Z-order) curve, spatially adjacent cells are adjacent in memory
+	};
+
+	//storage of the grid cells
+	enum class GridBackend {
+		automatic, //dense unless the bounding box has many more cells than there are points
+		dense,     //an array over all cells of the bounding box
+		sparse     //a hash table over the occupied cells only
+	};
+
+	//edge length of the grid cells. finer cells cover the query sphere more tightly, so fewer points are distance tested,
+	//at the price of more cells to look up per query
+	enum class GridResolution {
+		twiceRadius, //the 3x3x3 cells around the query cell
+		radius,      //the 5x5x5 cells around the query cell
+		halfRadius   //the cells of a 9x9x9 block around the query cell which can reach the query sphere
+	};
+
+	//how the seed search and the pivots find the points around a point or an edge
+	enum class NeighborSearch {
+		grid,       //query the spatial index on the fly every time
+		precomputed //build the neighbor list of every point once, in parallel, and take a pivot's candidates from the list of one
+		            //end point of its edge. the lists take the memory of all neighborhoods and an extra pass of queries to count
+		            //them, and in the benchmark they were never clearly faster than grid queries: about even on the bunny, and
+		            //0.82 to 0.89 times as fast from about 112 neighbors per point on. they can only pay off with small
+		            //neighborhoods, slow index queries and the build spread over many threads
+	};
+
+	//the structure the points are searched in
+	enum class SpatialIndexType {
+		grid,   //uniform cells of twice the radius, the fastest on evenly sampled surfaces
+		kdTree, //median splits down to small leaves, adapts to any density
+		octree  //adaptive octants down to small leaves, each searched by the bounds of its points
+	};
+
+	//optional settings of the reconstruction, the defaults give the plain algorithm
+	struct ReconstructionOptions {
+		SpatialIndexType spatialIndex = SpatialIndexType::grid;
+		//the cell order, backend and resolution only apply to the grid
+		CellOrder cellOrder = CellOrder::linear;
+		GridBackend gridBackend = GridBackend::automatic;
+		GridResolution gridResolution = GridResolution::twiceRadius;
+		NeighborSearch neighborSearch = NeighborSearch::grid;
+		//precomputed neighbor lists needing more memory than this fall back to grid queries, ReconstructionStats tells if they did
+		std::size_t neighborListMemoryLimit = std::size_t{1} << 30;
+		//threads of the parallel parts including the calling one, 0 uses all hardware threads. with the default of 1 everything
+		//runs on the calling thread and no thread is started
+		unsigned threads = 1;
+		//with more than one tile the points are split into this many runs of about the same size, which grow their fronts in
+		//parallel, each only over its own points. the edges between the tiles are pivoted afterwards on the joined fronts, so the
+		//mesh equals the one tile mesh up to the triangles along the seams. a few tiles per thread even out the load. the tiles
+		//are runs of cells, slabs in linear cell order and compact blocks in Morton order, whose seams are much shorter.
+		//the threads steal whole tiles from each other, but the components of one tile grow one after the other on one thread,
+		//so a large component still holds up the smaller ones of its tile. with one tile nothing is stolen
+		unsigned tiles = 1;
+		//active edges pivoted at the same time on the threads, 1 pivots one after the other. the pivots of a batch are committed
+		//in order, those an earlier commit made stale are pivoted again, so every committed pivot is exact. the mesh only depends
+		//on the batch size, not on the threads, and it works on a single surface. the tiles keep the threads busy on their own
+		//and pivot one edge after the other, so with tiles only the seams, the components seeded after the tiles and the later
+		//radii are pivoted in batches
+		unsigned pivotBatch = 1;
+	};
+
+
+	//what one worker did while the tiles grew: the tasks it ran, how many of them it stole from other workers, the time it
+	//spent in tasks and the time of the whole run
+	struct WorkerStatistics {
+		std::size_t tasks = 0;
+		std::size_t stolen = 0;
+		double busySeconds = 0;
+		double seconds = 0;
+
+		auto utilization() const -> double {
+			return seconds > 0 ? busySeconds / seconds : 0;
+		}
+	};
+
+	//the counters of ReconstructionStats
+	struct ReconstructionCounters {
+		//seeds found, and the unordered pairs of candidates, ball centers and emptiness tests their search took
+		std::uint64_t seeds = 0;
+		std::uint64_t seedPairs = 0;
+		std::uint64_t seedBalls = 0;
+		std::uint64_t seedEmptyBallTests = 0;
+		//pivots tried and those which made a triangle
+		std::uint64_t pivots = 0;
+		std::uint64_t pivotTriangles = 0;
+		//candidates in the neighborhoods of all pivots
+		std::uint64_t candidates = 0;
+		//pivots whose ball touched no candidate
+		std::uint64_t missed = 0;
+		//first hits rejected because the edge has an inner edge to them
+		std::uint64_t innerEdgeRejections = 0;
+		//balls of pivots and of reactivated boundary edges tested for emptiness, and the pivots whose ball was not empty
+		std::uint64_t emptyBallTests = 0;
+		std::uint64_t nonEmptyBalls = 0;
+		//batches of pivots computed in parallel, and those of their pivots which an earlier commit of the batch made stale,
+		//they were pivoted again
+		std::uint64_t batches = 0;
+		std::uint64_t retries = 0;
+		//glues of the paper's cases: 1 a loop of two edges, 2 neighboring edges, 3 edges of one loop, which splits it,
+		//4 edges of two loops, which joins them
+		std::array<std::uint64_t, 4> glueCases{};
+		//edges on the boundary at the end
+		std::uint64_t boundaryEdges = 0;
+		//the most front edges (active and boundary) at once. with tiles, the most of any tile or of the fronts merged from them
+		std::uint64_t peakFrontEdges = 0;
+		//pivots by the points in their neighborhood: bucket 0 counts the empty ones, bucket i those of 2^(i-1) to 2^i - 1
+		//points, the last bucket all larger ones too
+		std::array<std::uint64_t, 16> neighborhoodSizes{};
+
+		auto operator+=(const ReconstructionCounters& other) -> ReconstructionCounters&;
+	};
+
+	//what a reconstruction did and where its time went. the times are always measured, the counters (those of the seed search
+	//too) only if the library is built with BPA_STATISTICS, otherwise counting is compiled out and counted is false
+	struct ReconstructionStats {
+		//seconds spent building the spatial index, precomputing the neighbor lists, in the serial seed search, growing the
+		//tiles (their seed search included) and in the pivot loop outside of the tiles, and in the whole reconstruction
+		double indexSeconds = 0;
+		double neighborListSeconds = 0;
+		double seedSeconds = 0;
+		double tileSeconds = 0;
+		double pivotSeconds = 0;
+		double totalSeconds = 0;
+		//what the workers did while the tiles grew, empty without tiles
+		std::vector<WorkerStatistics> workers;
+		//whether precomputed neighbor lists were asked for but needed more than neighborListMemoryLimit, so the index was
+		//queried instead, in any pass
+		bool neighborListFallback = false;
+		bool counted = false;
+		ReconstructionCounters counters;
+	};
+
+
 	//defined date structures for reconstruction
 	struct MeshEdge;
-	struct MeshPoint;
-	enum class EdgeStatus;
+	struct PointStates;
+	struct Fronts;
+	enum class EdgeStatus : std::uint32_t;
 	struct MeshFace;
 	struct Grid;
+	struct KdTree;
+	struct Octree;
 	struct SeedResult;
 	struct PivotResult;
 
 
 	//takes points and radius as input, this function gives faces as output
 	auto reconstruct(const std::vector<Point>& points, float radius) -> std::vector<Triangle>;
+	auto reconstruct(const std::vector<Point>& points, float radius, const ReconstructionOptions& options) -> std::vector<Triangle>;
+	//the same faces as an indexed mesh: every three entries are the indices of the points of a face in the input, a third of the
+	//memory of the positions and exact also for points with the same position
+	auto reconstructIndexed(const std::vector<Point>& points, float radius) -> std::vector<std::uint32_t>;
+	auto reconstructIndexed(const std::vector<Point>& points, float radius, const ReconstructionOptions& options) -> std::vector<std::uint32_t>;
+	//passes over increasing radii as in the paper: every radius after the first pivots the boundary edges the smaller ones left
+	//and seeds the points still unused. the spatial index is built once, for the smallest radius. this closes only part of the
+	//holes: many small holes of the smaller radii have no empty ball of a larger one, on the bunny 0.001 and 0.002 leave about
+	//five times the border edges of 0.002 alone
+	auto reconstruct(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options) -> std::vector<Triangle>;
+	auto reconstructIndexed(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options) -> std::vector<std::uint32_t>;
+	//the same, filling stats with the times and counters of the reconstruction
+	auto reconstruct(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options, ReconstructionStats& stats) -> std::vector<Triangle>;
+	auto reconstructIndexed(const std::vector<Point>& points, const std::vector<float>& radii, const ReconstructionOptions& options, ReconstructionStats& stats)
+		-> std::vector<std::uint32_t>;
 }
 
 #endif
\ No newline at end of file
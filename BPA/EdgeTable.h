@@ -0,0 +1,148 @@
+#ifndef BallPivotingEdgeTable
+#define BallPivotingEdgeTable
+
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace BPA {
+
+	//the key of the edge from point slot a to point slot b
+	inline auto edgeKey(std::uint32_t a, std::uint32_t b) -> std::uint64_t {
+		return std::uint64_t{a} << 32 | b;
+	}
+
+	//the key of the edge between a and b, whichever way it runs
+	inline auto undirectedEdgeKey(std::uint32_t a, std::uint32_t b) -> std::uint64_t {
+		return edgeKey(std::min(a, b), std::max(a, b));
+	}
+
+	//open addressing hash table from edge keys to values, absent is the value of the keys not in it. it is kept at most half full,
+	//erasing shifts the following entries of the probe sequence back instead of leaving tombstones, so lookups stay short however
+	//often edges come and go
+	template <typename Value, Value absent = Value{}>
+	struct EdgeTable {
+		static constexpr std::uint64_t emptyKey = std::numeric_limits<std::uint64_t>::max();
+
+		struct Entry {
+			std::uint64_t key = emptyKey;
+			Value value = absent;
+		};
+
+		//the value of key, or absent if key is not present
+		auto find(std::uint64_t key) const -> Value {
+			if (entries.empty())
+				return absent;
+			for (auto i = bucket(key);; i = (i + 1) & mask) {
+				if (entries[i].key == key)
+					return entries[i].value;
+				if (entries[i].key == emptyKey)
+					return absent;
+			}
+		}
+
+		auto contains(std::uint64_t key) const -> bool {
+			if (entries.empty())
+				return false;
+			for (auto i = bucket(key);; i = (i + 1) & mask) {
+				if (entries[i].key == key)
+					return true;
+				if (entries[i].key == emptyKey)
+					return false;
+			}
+		}
+
+		//inserts key with the given value, if the key is already present nothing changes
+		void insert(std::uint64_t key, Value value) {
+			if (2 * (size + 1) > entries.size())
+				rehash(std::max<std::size_t>(16, entries.size() * 2));
+			for (auto i = bucket(key);; i = (i + 1) & mask) {
+				if (entries[i].key == key)
+					return;
+				if (entries[i].key == emptyKey) {
+					entries[i] = {key, value};
+					size++;
+					return;
+				}
+			}
+		}
+
+		//removes key if it is present with the given value
+		void erase(std::uint64_t key, Value value) {
+			if (entries.empty())
+				return;
+			auto i = bucket(key);
+			for (; entries[i].key != key; i = (i + 1) & mask)
+				if (entries[i].key == emptyKey)
+					return;
+			if (!(entries[i].value == value))
+				return;
+			//move every following entry of the run whose home bucket is not between the hole and itself into the hole
+			for (auto j = (i + 1) & mask; entries[j].key != emptyKey; j = (j + 1) & mask) {
+				const auto home = bucket(entries[j].key);
+				const auto staysBehindHole = i <= j ? i < home && home <= j : i < home || home <= j;
+				if (!staysBehindHole) {
+					entries[i] = entries[j];
+					i = j;
+				}
+			}
+			entries[i] = Entry{};
+			size--;
+		}
+
+		//removes all entries, the capacity is kept
+		void clear() {
+			std::fill(begin(entries), end(entries), Entry{});
+			size = 0;
+		}
+
+		//removes all entries and frees the capacity
+		void release() {
+			std::vector<Entry>().swap(entries);
+			mask = 0;
+			size = 0;
+		}
+
+		//whether the next insert grows the table
+		auto full() const -> bool {
+			return 2 * (size + 1) > entries.size();
+		}
+
+		//removes every entry for which stale(key, value) holds. the capacity is kept unless the table is still more than a
+		//quarter full, then it is doubled, so a prune is always followed by at least a quarter of the capacity in inserts
+		template <typename Stale>
+		void prune(Stale stale) {
+			auto old = std::move(entries);
+			entries.assign(old.size(), Entry{});
+			size = 0;
+			for (const auto& e : old)
+				if (e.key != emptyKey && !stale(e.key, e.value))
+					insert(e.key, e.value);
+			if (4 * size > entries.size())
+				rehash(entries.size() * 2);
+		}
+
+		auto bucket(std::uint64_t key) const -> std::size_t {
+			return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+		}
+
+		void rehash(std::size_t capacity) {
+			auto old = std::move(entries);
+			entries.assign(capacity, Entry{});
+			mask = capacity - 1;
+			size = 0;
+			for (const auto& e : old)
+				if (e.key != emptyKey)
+					insert(e.key, e.value);
+		}
+
+		std::vector<Entry> entries;
+		std::size_t mask = 0;
+		std::size_t size = 0;
+	};
+}
+
+#endif
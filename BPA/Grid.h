@@ -0,0 +1,406 @@
+#ifndef BallPivotingGrid
+#define BallPivotingGrid
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include "SpatialIndex.h"
+
+namespace BPA {
+
+	//interleaves the lowest 21 bits of x, y and z into a 63 bit Morton (Z-order) code
+	inline auto mortonCode(glm::uvec3 v) -> std::uint64_t {
+		const auto spread = [](std::uint64_t x) {
+			x &= 0x1fffff;
+			x = (x | x << 32) & 0x1f00000000ffff;
+			x = (x | x << 16) & 0x1f0000ff0000ff;
+			x = (x | x << 8) & 0x100f00f00f00f00f;
+			x = (x | x << 4) & 0x10c30c30c30c30c3;
+			x = (x | x << 2) & 0x1249249249249249;
+			return x;
+		};
+		return spread(v.x) | spread(v.y) << 1 | spread(v.z) << 2;
+	}
+
+	//the cells [xFirst, xLast] of one row along x, relative to the center cell. in linear order the cells of a row have
+	//consecutive slots, so their points form one contiguous run
+	struct StencilRow {
+		int xFirst;
+		int xLast;
+		int y;
+		int z;
+	};
+
+	//how far a cell d cells away along an axis is at least from every point of the center cell, in cells
+	constexpr auto cellGap(int d) -> int {
+		return d < -1 ? -d - 1 : d > 1 ? d - 1 : 0;
+	}
+
+	//the half width of the stencil row (y, z) of a grid with subdivisions cells per query radius, -1 if the row is empty.
+	//a cell belongs to the stencil if it can hold a point closer than the query radius to some point of the center cell
+	constexpr auto stencilRowWidth(int subdivisions, int y, int z) -> int {
+		auto width = -1;
+		for (auto x = 0; x <= subdivisions; x++)
+			if (cellGap(x) * cellGap(x) + cellGap(y) * cellGap(y) + cellGap(z) * cellGap(z) <= subdivisions * subdivisions)
+				width = x;
+		return width;
+	}
+
+	template <int subdivisions>
+	constexpr auto stencilSize() -> std::size_t {
+		if (subdivisions == 1)
+			return 27;
+		std::size_t size = 0;
+		for (auto z = -subdivisions; z <= subdivisions; z++)
+			for (auto y = -subdivisions; y <= subdivisions; y++)
+				size += stencilRowWidth(subdivisions, y, z) >= 0;
+		return size;
+	}
+
+	//the rows of cells a query visits around the cell of the query point, computed at compile time for every supported resolution.
+	//the 3x3x3 stencil of the default resolution keeps the cell order of the original x-y-z loop, one cell per row, so the
+	//reconstruction does not change with it
+	template <int subdivisions>
+	constexpr auto makeStencil() -> std::array<StencilRow, stencilSize<subdivisions>()> {
+		std::array<StencilRow, stencilSize<subdivisions>()> stencil{};
+		std::size_t size = 0;
+		if (subdivisions == 1) {
+			for (auto x = -1; x <= 1; x++)
+				for (auto y = -1; y <= 1; y++)
+					for (auto z = -1; z <= 1; z++)
+						stencil[size++] = {x, x, y, z};
+			return stencil;
+		}
+		for (auto z = -subdivisions; z <= subdivisions; z++)
+			for (auto y = -subdivisions; y <= subdivisions; y++)
+				if (const auto width = stencilRowWidth(subdivisions, y, z); width >= 0)
+					stencil[size++] = {-width, width, y, z};
+		return stencil;
+	}
+
+	template <int subdivisions>
+	inline constexpr auto cellStencil = makeStencil<subdivisions>();
+
+	//the same rows for any number of subdivisions, computed at run time for the resolutions without a precomputed stencil
+	inline auto makeStencilRows(int subdivisions) -> std::vector<StencilRow> {
+		std::vector<StencilRow> rows;
+		for (auto z = -subdivisions; z <= subdivisions; z++)
+			for (auto y = -subdivisions; y <= subdivisions; y++)
+				if (const auto width = stencilRowWidth(subdivisions, y, z); width >= 0)
+					rows.push_back({-width, width, y, z});
+		return rows;
+	}
+
+	//open addressing hash table from packed cell coordinates to slots, only the occupied cells of a sparse grid are stored
+	struct SparseCellTable {
+		static constexpr std::uint64_t emptyKey = std::numeric_limits<std::uint64_t>::max();
+		static constexpr std::uint32_t notFound = std::numeric_limits<std::uint32_t>::max();
+
+		struct Entry {
+			std::uint64_t key = emptyKey;
+			std::uint32_t slot = notFound;
+		};
+
+		auto find(std::uint64_t key) const -> std::uint32_t {
+			if (entries.empty())
+				return notFound;
+			for (auto i = bucket(key);; i = (i + 1) & mask) {
+				if (entries[i].key == key)
+					return entries[i].slot;
+				if (entries[i].key == emptyKey)
+					return notFound;
+			}
+		}
+
+		//inserts key with the given slot, if the key is already present its slot is returned and nothing changes
+		auto insert(std::uint64_t key, std::uint32_t slot) -> std::uint32_t {
+			if (2 * (size + 1) > entries.size())
+				rehash(std::max<std::size_t>(16, entries.size() * 2));
+			for (auto i = bucket(key);; i = (i + 1) & mask) {
+				if (entries[i].key == key)
+					return entries[i].slot;
+				if (entries[i].key == emptyKey) {
+					entries[i] = {key, slot};
+					size++;
+					return slot;
+				}
+			}
+		}
+
+		void assign(std::uint64_t key, std::uint32_t slot) {
+			for (auto i = bucket(key);; i = (i + 1) & mask) {
+				if (entries[i].key == key) {
+					entries[i].slot = slot;
+					return;
+				}
+			}
+		}
+
+		auto bucket(std::uint64_t key) const -> std::size_t {
+			return static_cast<std::size_t>((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+		}
+
+		void rehash(std::size_t capacity) {
+			auto old = std::move(entries);
+			entries.assign(capacity, Entry{});
+			mask = capacity - 1;
+			size = 0;
+			for (const auto& e : old)
+				if (e.key != emptyKey)
+					insert(e.key, e.slot);
+		}
+
+		std::vector<Entry> entries;
+		std::size_t mask = 0;
+		std::size_t size = 0;
+	};
+
+	//the sum of all cubes, which is the entire input space covering all the points.
+	//the point slots are sorted by cell, the cell in slot s owns the run [cellStart[s], cellStart[s + 1]).
+	//the dense backend keeps a slot for every cell of the bounding box: with linear order the slot of a cell is its linear index,
+	//with Morton order cellSlot maps the linear index to the slot. the sparse backend only gives occupied cells a slot and finds them
+	//through a hash table, so its memory scales with the point count instead of the bounding box volume.
+	//without a slot of their own, empty cells share one empty slot behind the last run.
+	//a query visits the cells of the precomputed stencil of the grid's resolution around the cell of the query point
+	struct Grid : SpatialIndex<Grid> {
+		//cell coordinates are packed into 21 bits per axis
+		static constexpr int maxCellsPerAxis = 1 << 21;
+		//the automatic backend is dense as long as the occupancy ratio can reach 1 / denseCellsPerPoint, i.e. the bounding box
+		//has at most that many cells of the twiceRadius resolution per point. such a cell table is still small next to the points
+		//and dense lookups are faster. the finer resolutions have subdivisions^3 cells in one of those, the threshold grows with
+		//them, otherwise they would almost always get the much slower sparse backend
+		static constexpr std::uint64_t denseCellsPerPoint = 32;
+
+		Grid(const std::vector<Point>& points, float radius, CellOrder order = CellOrder::linear, GridBackend backend = GridBackend::automatic,
+			GridResolution resolution = GridResolution::twiceRadius)
+			: subdivisions(resolution == GridResolution::halfRadius ? 4 : resolution == GridResolution::radius ? 2 : 1) {
+			queryRadius = radius * 2;
+			cellSize = queryRadius / subdivisions;
+			lower = points.front().pos;
+			upper = points.front().pos;
+
+			for (const auto& p : points) {
+				for (auto i = 0; i < 3; i++) {
+					lower[i] = std::min(lower[i], p.pos[i]);
+					upper[i] = std::max(upper[i], p.pos[i]);
+				}
+			}
+
+			const auto cellsPerAxis = glm::ceil((upper - lower) / cellSize);
+			truncated = glm::any(glm::greaterThan(cellsPerAxis, glm::vec3{maxCellsPerAxis}));
+			dims = glm::ivec3{glm::clamp(cellsPerAxis, glm::vec3{1}, glm::vec3{maxCellsPerAxis})};
+
+			const auto totalCells = static_cast<std::uint64_t>(dims.x) * dims.y * dims.z;
+			if (backend == GridBackend::automatic)
+				backend = totalCells <= denseCellsPerPoint * subdivisions * subdivisions * subdivisions * points.size() ? GridBackend::dense : GridBackend::sparse;
+			if (totalCells >= std::numeric_limits<std::uint32_t>::max())
+				backend = GridBackend::sparse;
+			sparse = backend == GridBackend::sparse;
+
+			if (order == CellOrder::morton)
+				sortAlongMortonCurve(points);
+			else if (sparse)
+				sortSparse(points);
+			else
+				sortLinear(points);
+			storePositions(points);
+		}
+
+		//two counting passes: count the points of every cell, the prefix sum of the counts gives the start of each run,
+		//then scatter the points into their runs. the input order is kept inside a cell
+		void sortLinear(const std::vector<Point>& points) {
+			std::vector<std::uint32_t> pointCell(points.size());
+			cellStart.assign(static_cast<std::size_t>(dims.x) * dims.y * dims.z + 1, 0);
+			for (std::size_t i = 0; i < points.size(); i++) {
+				pointCell[i] = linearIndex(cellIndex(points[i].pos));
+				cellStart[pointCell[i] + 1]++;
+			}
+			std::partial_sum(begin(cellStart), end(cellStart), begin(cellStart));
+
+			std::vector<std::uint32_t> fill(begin(cellStart), end(cellStart) - 1);
+			ids.resize(points.size());
+			for (std::size_t i = 0; i < points.size(); i++)
+				ids[fill[pointCell[i]]++] = static_cast<std::uint32_t>(i);
+		}
+
+		//the same two counting passes over the occupied cells only. the occupied cells are collected in the hash table
+		//and then numbered in z-y-x order, so the slots come in the same order as with the dense backend
+		void sortSparse(const std::vector<Point>& points) {
+			std::vector<std::uint32_t> pointCell(points.size());
+			std::vector<std::uint64_t> occupied;
+			for (std::size_t i = 0; i < points.size(); i++) {
+				const auto key = packedIndex(cellIndex(points[i].pos));
+				pointCell[i] = cellTable.insert(key, static_cast<std::uint32_t>(occupied.size()));
+				if (pointCell[i] == occupied.size())
+					occupied.push_back(key);
+			}
+
+			std::vector<std::uint32_t> byKey(occupied.size());
+			std::iota(begin(byKey), end(byKey), 0);
+			std::sort(begin(byKey), end(byKey), [&](std::uint32_t a, std::uint32_t b) { return occupied[a] < occupied[b]; });
+			std::vector<std::uint32_t> cellSlotOf(occupied.size());
+			for (std::uint32_t s = 0; s < byKey.size(); s++) {
+				cellSlotOf[byKey[s]] = s;
+				cellTable.assign(occupied[byKey[s]], s);
+			}
+
+			cellStart.assign(occupied.size() + 2, 0);
+			for (auto& c : pointCell) {
+				c = cellSlotOf[c];
+				cellStart[c + 1]++;
+			}
+			std::partial_sum(begin(cellStart), end(cellStart), begin(cellStart));
+
+			std::vector<std::uint32_t> fill(begin(cellStart), end(cellStart) - 1);
+			ids.resize(points.size());
+			for (std::size_t i = 0; i < points.size(); i++)
+				ids[fill[pointCell[i]]++] = static_cast<std::uint32_t>(i);
+		}
+
+		//sorts the points by the Morton code of their cell, then by the Morton code of their position inside the cell.
+		//only occupied cells get a slot
+		void sortAlongMortonCurve(const std::vector<Point>& points) {
+			struct Key {
+				std::uint64_t cell;
+				std::uint32_t inCell;
+				std::uint32_t index;
+			};
+			std::vector<Key> keys(points.size());
+			for (std::size_t i = 0; i < points.size(); i++) {
+				const auto index = cellIndex(points[i].pos);
+				const auto inCell = glm::clamp((points[i].pos - lower) / cellSize - glm::vec3{index}, 0.0f, 1.0f) * 1023.0f;
+				keys[i] = {mortonCode(glm::uvec3{index}), static_cast<std::uint32_t>(mortonCode(glm::uvec3{inCell})), static_cast<std::uint32_t>(i)};
+			}
+			std::sort(begin(keys), end(keys), [](const Key& a, const Key& b) {
+				return std::tie(a.cell, a.inCell, a.index) < std::tie(b.cell, b.inCell, b.index);
+			});
+
+			constexpr auto unassigned = std::numeric_limits<std::uint32_t>::max();
+			if (!sparse)
+				cellSlot.assign(static_cast<std::size_t>(dims.x) * dims.y * dims.z, unassigned);
+			cellStart.clear();
+			ids.resize(points.size());
+			for (std::size_t i = 0; i < keys.size(); i++) {
+				const auto& p = points[keys[i].index];
+				if (i == 0 || keys[i].cell != keys[i - 1].cell) {
+					const auto slot = static_cast<std::uint32_t>(cellStart.size());
+					if (sparse)
+						cellTable.insert(packedIndex(cellIndex(p.pos)), slot);
+					else
+						cellSlot[linearIndex(cellIndex(p.pos))] = slot;
+					cellStart.push_back(static_cast<std::uint32_t>(i));
+				}
+				ids[i] = keys[i].index;
+			}
+			cellStart.push_back(static_cast<std::uint32_t>(points.size()));
+			cellStart.push_back(static_cast<std::uint32_t>(points.size()));
+			std::replace(begin(cellSlot), end(cellSlot), unassigned, emptySlot());
+		}
+
+		auto cellIndex(glm::vec3 point) const -> glm::ivec3 {
+			const auto index = glm::ivec3{(point - lower) / cellSize};
+			return glm::clamp(index, glm::ivec3{}, dims - 1);
+		}
+
+		auto linearIndex(glm::ivec3 index) const -> std::uint32_t {
+			return static_cast<std::uint32_t>(index.z) * dims.x * dims.y + static_cast<std::uint32_t>(index.y) * dims.x + index.x;
+		}
+
+		//21 bits per axis, z-y-x order like the linear index
+		auto packedIndex(glm::ivec3 index) const -> std::uint64_t {
+			return static_cast<std::uint64_t>(index.z) << 42 | static_cast<std::uint64_t>(index.y) << 21 | static_cast<std::uint64_t>(index.x);
+		}
+
+		auto emptySlot() const -> std::uint32_t {
+			return static_cast<std::uint32_t>(cellStart.size() - 2);
+		}
+
+		auto slot(glm::ivec3 index) const -> std::uint32_t {
+			if (sparse) {
+				const auto s = cellTable.find(packedIndex(index));
+				return s == SparseCellTable::notFound ? emptySlot() : s;
+			}
+			return cellSlot.empty() ? linearIndex(index) : cellSlot[linearIndex(index)];
+		}
+
+		using SpatialIndex::cell;
+		using SpatialIndex::forEachNeighbor;
+
+		//queries for a larger radius on the same cells: a query visits every cell within the new query radius, so the grid of
+		//the smallest radius of a reconstruction serves all its radii without sorting the points again
+		void setRadius(float radius) {
+			queryRadius = radius * 2;
+			subdivisions = std::max(1, static_cast<int>(std::ceil(queryRadius / cellSize)));
+			if (subdivisions != 1 && subdivisions != 2 && subdivisions != 4)
+				wideStencil = makeStencilRows(subdivisions);
+		}
+
+		auto cell(glm::ivec3 index) -> Cell {
+			return cell(slot(index));
+		}
+
+		//calls visit(first, last) for every run of cells with the consecutive slots [first, last] in the stencil around the
+		//cell of point. only the dense backend with linear order has whole rows in consecutive slots, otherwise every run is a single cell
+		template <typename Visitor>
+		void forEachCellRun(glm::vec3 point, Visitor&& visit) {
+			switch (subdivisions) {
+				case 1: return forEachCellRun(cellStencil<1>, point, visit);
+				case 2: return forEachCellRun(cellStencil<2>, point, visit);
+				case 4: return forEachCellRun(cellStencil<4>, point, visit);
+				default: return forEachCellRun(wideStencil, point, visit);
+			}
+		}
+
+		template <typename Stencil, typename Visitor>
+		void forEachCellRun(const Stencil& stencil, glm::vec3 point, Visitor& visit) {
+			const auto centerIndex = cellIndex(point);
+			const auto rowsAreRuns = !sparse && cellSlot.empty();
+			for (const auto& row : stencil) {
+				const auto y = centerIndex.y + row.y;
+				const auto z = centerIndex.z + row.z;
+				if (y < 0 || y >= dims.y) continue;
+				if (z < 0 || z >= dims.z) continue;
+				const auto xFirst = std::max(centerIndex.x + row.xFirst, 0);
+				const auto xLast = std::min(centerIndex.x + row.xLast, dims.x - 1);
+				if (xFirst > xLast) continue;
+				if (rowsAreRuns)
+					visit(linearIndex({xFirst, y, z}), linearIndex({xLast, y, z}));
+				else
+					for (auto x = xFirst; x <= xLast; x++) {
+						const auto s = slot({x, y, z});
+						visit(s, s);
+					}
+			}
+		}
+
+		//visits the points of the stencil cells around the cell of point
+		template <typename Visitor>
+		void forEachNeighbor(glm::vec3 point, IgnoredPoints ignore, Visitor&& visit) {
+			forEachCellRun(point, [&](std::uint32_t first, std::uint32_t last) { visitRange(cellStart[first], cellStart[last + 1], point, ignore, visit); });
+		}
+
+		glm::vec3 lower;
+		glm::vec3 upper;
+		float cellSize;
+		//cells per query radius
+		int subdivisions;
+		//the stencil of subdivisions without a precomputed one
+		std::vector<StencilRow> wideStencil;
+		glm::ivec3 dims;
+		std::vector<std::uint32_t> cellSlot;
+		SparseCellTable cellTable;
+		bool sparse = false;
+		bool truncated = false;
+	};
+}
+
+#endif
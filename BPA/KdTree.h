@@ -0,0 +1,102 @@
+#ifndef BallPivotingKdTree
+#define BallPivotingKdTree
+
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "SpatialIndex.h"
+
+namespace BPA {
+
+	//a k-d tree over the points: every node splits its points at the median of the longest axis of their bounds, until at most
+	//leafSize points are left. the points are stored in the depth first order of the leaves, so every leaf is a cell with a
+	//contiguous run of points. every node keeps the tight bounds of its points, a query descends into the nodes whose bounds
+	//are closer than queryRadius. unlike the grid the cells adapt to the density, so dense and sparse regions cost the same
+	struct KdTree : SpatialIndex<KdTree> {
+		static constexpr std::uint32_t leafSize = 32;
+
+		struct Node {
+			glm::vec3 lower;
+			glm::vec3 upper;
+			//the points of the node are the slots [first, last)
+			std::uint32_t first;
+			std::uint32_t last;
+			//the children are the nodes left and left + 1, a leaf has left == 0
+			std::uint32_t left = 0;
+		};
+
+		KdTree(const std::vector<Point>& points, float radius) {
+			queryRadius = radius * 2;
+			std::vector<std::uint32_t> order(points.size());
+			std::iota(begin(order), end(order), 0);
+			nodes.reserve(2 * (points.size() / leafSize + 1));
+			nodes.push_back({});
+			split(0, points, order, 0, static_cast<std::uint32_t>(points.size()));
+			cellStart.push_back(static_cast<std::uint32_t>(points.size()));
+
+			ids = std::move(order);
+			storePositions(points);
+		}
+
+		void split(std::uint32_t node, const std::vector<Point>& points, std::vector<std::uint32_t>& order, std::uint32_t first, std::uint32_t last) {
+			auto lower = points[order[first]].pos;
+			auto upper = lower;
+			for (auto i = first; i < last; i++) {
+				lower = glm::min(lower, points[order[i]].pos);
+				upper = glm::max(upper, points[order[i]].pos);
+			}
+			nodes[node] = Node{lower, upper, first, last};
+			if (last - first <= leafSize) {
+				cellStart.push_back(first);
+				return;
+			}
+
+			const auto extent = upper - lower;
+			const auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+			const auto middle = first + (last - first) / 2;
+			std::nth_element(begin(order) + first, begin(order) + middle, begin(order) + last, [&](std::uint32_t a, std::uint32_t b) {
+				const auto pa = points[a].pos[axis];
+				const auto pb = points[b].pos[axis];
+				return pa < pb || (pa == pb && a < b);
+			});
+
+			const auto left = static_cast<std::uint32_t>(nodes.size());
+			nodes[node].left = left;
+			nodes.push_back({});
+			nodes.push_back({});
+			split(left, points, order, first, middle);
+			split(left + 1, points, order, middle, last);
+		}
+
+		//visits the points of the leaves whose bounds are closer than queryRadius to point
+		template <typename Visitor>
+		void forEachNeighbor(glm::vec3 point, IgnoredPoints ignore, Visitor&& visit) {
+			const auto radius2 = queryRadius * queryRadius;
+			std::uint32_t stack[64];
+			std::size_t size = 0;
+			stack[size++] = 0;
+			while (size > 0) {
+				const auto& node = nodes[stack[--size]];
+				if (distance2ToBox(point, node.lower, node.upper) >= radius2)
+					continue;
+				if (node.left == 0) {
+					visitRange(node.first, node.last, point, ignore, visit);
+					continue;
+				}
+				stack[size++] = node.left + 1;
+				stack[size++] = node.left;
+			}
+		}
+
+		using SpatialIndex::forEachNeighbor;
+
+		std::vector<Node> nodes;
+	};
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef BallPivotingNeighborLists
+#define BallPivotingNeighborLists
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtx/norm.hpp>
+
+#include "SpatialIndex.h"
+#include "ThreadPool.h"
+
+namespace BPA {
+
+	//the neighbors closer than index.queryRadius (2 * radius) of every point, precomputed once per reconstruction in CSR layout:
+	//the point in slot i of the spatial index has the neighbors [offsets[i], offsets[i + 1]) in neighbors, as slots
+	struct NeighborLists {
+		//builds the lists in two parallel passes over blocks of points: the first counts the neighbors of every point, which gives
+		//the offsets and the size of the lists before any of them is stored, the second queries the index again and writes every
+		//list straight to its place. returns false and stays empty if the lists would need more than memoryLimit bytes, the
+		//counting pass finds that out before anything is allocated for the lists
+		template <typename Index>
+		auto build(Index& index, ThreadPool& pool, std::size_t memoryLimit) -> bool {
+			const std::size_t n = index.size();
+			constexpr std::size_t block = 4096;
+			const auto blocks = (n + block - 1) / block;
+			const auto maxNeighbors = std::min<std::size_t>(memoryLimit / sizeof(std::uint32_t), std::numeric_limits<std::uint32_t>::max());
+			if (n + 1 > maxNeighbors)
+				return false;
+
+			std::vector<std::uint32_t> counts(n + 1);
+			std::atomic<std::size_t> total{n + 1};
+			pool.parallelFor(blocks, [&](std::size_t b) {
+				if (total > maxNeighbors)
+					return;
+				std::size_t blockTotal = 0;
+				for (auto i = b * block; i < std::min(n, (b + 1) * block); i++) {
+					const auto slot = static_cast<std::uint32_t>(i);
+					std::uint32_t count = 0;
+					index.forEachNeighbor(index.position(slot), {slot}, [&](std::uint32_t) { count++; });
+					counts[i + 1] = count;
+					blockTotal += count;
+				}
+				total += blockTotal;
+			});
+			if (total > maxNeighbors)
+				return false;
+
+			offsets = std::move(counts);
+			std::partial_sum(begin(offsets), end(offsets), begin(offsets));
+			neighbors.resize(offsets[n]);
+			pool.parallelFor(blocks, [&](std::size_t b) {
+				for (auto i = b * block; i < std::min(n, (b + 1) * block); i++) {
+					const auto slot = static_cast<std::uint32_t>(i);
+					auto* list = neighbors.data() + offsets[i];
+					index.forEachNeighbor(index.position(slot), {slot}, [&](std::uint32_t p) { *list++ = p; });
+				}
+			});
+			return true;
+		}
+
+		auto empty() const -> bool {
+			return offsets.empty();
+		}
+
+		//fills result with the points of the list of a which are closer than sqrt(radius2) to center, except the ignored ones.
+		//the list of a alone is enough for a pivot around the edge (a, b): the ball touches a, so every point it can reach
+		//or contain is closer than 2 * radius to a
+		template <typename Index>
+		void around(const Index& index, std::uint32_t a, glm::vec3 center, float radius2, IgnoredPoints ignore, std::vector<std::uint32_t>& result) const {
+			result.clear();
+			for (auto i = offsets[a]; i < offsets[a + 1]; i++) {
+				const auto slot = neighbors[i];
+				const auto d = index.position(slot) - center;
+				if (glm::dot(d, d) < radius2 && slot != ignore.b && slot != ignore.c)
+					result.push_back(slot);
+			}
+		}
+
+		//fills result with the list of point a
+		void of(std::uint32_t a, std::vector<std::uint32_t>& result) const {
+			result.assign(neighbors.data() + offsets[a], neighbors.data() + offsets[a + 1]);
+		}
+
+		std::vector<std::uint32_t> offsets;
+		std::vector<std::uint32_t> neighbors;
+	};
+}
+
+#endif
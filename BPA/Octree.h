@@ -0,0 +1,131 @@
+#ifndef BallPivotingOctree
+#define BallPivotingOctree
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "SpatialIndex.h"
+
+namespace BPA {
+
+	//an adaptive octree over the points: a node is split into its eight octants until at most leafSize points are left
+	//or maxDepth is reached, empty octants get no node. the points are stored in the depth first order of the leaves, so every
+	//leaf is a cell with a contiguous run of points. the octants cut the space regularly, but for the queries every node is
+	//loosened to the tight bounds of its points, which are usually much smaller than its octant on scanned surfaces
+	struct Octree : SpatialIndex<Octree> {
+		static constexpr std::uint32_t leafSize = 32;
+		static constexpr int maxDepth = 21;
+
+		struct Node {
+			glm::vec3 lower;
+			glm::vec3 upper;
+			//the points of the node are the slots [first, last)
+			std::uint32_t first;
+			std::uint32_t last;
+			//the children are the nodes [firstChild, firstChild + childCount), a leaf has no children
+			std::uint32_t firstChild = 0;
+			std::uint32_t childCount = 0;
+		};
+
+		Octree(const std::vector<Point>& points, float radius) {
+			queryRadius = radius * 2;
+			auto lower = points.front().pos;
+			auto upper = points.front().pos;
+			for (const auto& p : points) {
+				lower = glm::min(lower, p.pos);
+				upper = glm::max(upper, p.pos);
+			}
+			//the root is the cube around the bounding box
+			const auto size = glm::max(upper.x - lower.x, glm::max(upper.y - lower.y, upper.z - lower.z));
+
+			std::vector<std::uint32_t> order(points.size());
+			std::iota(begin(order), end(order), 0);
+			std::vector<std::uint32_t> scratch(points.size());
+			nodes.push_back({});
+			split(0, points, order, scratch, 0, static_cast<std::uint32_t>(points.size()), lower, size, 0);
+			cellStart.push_back(static_cast<std::uint32_t>(points.size()));
+
+			ids = std::move(order);
+			storePositions(points);
+		}
+
+		void split(std::uint32_t node, const std::vector<Point>& points, std::vector<std::uint32_t>& order, std::vector<std::uint32_t>& scratch,
+			std::uint32_t first, std::uint32_t last, glm::vec3 corner, float size, int depth) {
+			auto lower = points[order[first]].pos;
+			auto upper = lower;
+			for (auto i = first; i < last; i++) {
+				lower = glm::min(lower, points[order[i]].pos);
+				upper = glm::max(upper, points[order[i]].pos);
+			}
+			nodes[node] = Node{lower, upper, first, last};
+			if (last - first <= leafSize || depth == maxDepth) {
+				cellStart.push_back(first);
+				return;
+			}
+
+			//counting sort of the points by octant, keeping their order inside an octant
+			const auto half = size / 2;
+			const auto center = corner + half;
+			const auto octant = [&](std::uint32_t i) {
+				const auto& pos = points[i].pos;
+				return (pos.x >= center.x ? 1 : 0) | (pos.y >= center.y ? 2 : 0) | (pos.z >= center.z ? 4 : 0);
+			};
+			std::array<std::uint32_t, 9> start{};
+			for (auto i = first; i < last; i++)
+				start[octant(order[i]) + 1]++;
+			std::partial_sum(begin(start), end(start), begin(start));
+			auto fill = start;
+			for (auto i = first; i < last; i++)
+				scratch[first + fill[octant(order[i])]++] = order[i];
+			std::copy(begin(scratch) + first, begin(scratch) + last, begin(order) + first);
+
+			const auto firstChild = static_cast<std::uint32_t>(nodes.size());
+			std::uint32_t childCount = 0;
+			for (auto o = 0; o < 8; o++)
+				childCount += start[o] != start[o + 1];
+			nodes[node].firstChild = firstChild;
+			nodes[node].childCount = childCount;
+			nodes.resize(nodes.size() + childCount);
+
+			auto child = firstChild;
+			for (auto o = 0; o < 8; o++) {
+				if (start[o] == start[o + 1])
+					continue;
+				const auto childCorner = corner + glm::vec3{o & 1 ? half : 0, o & 2 ? half : 0, o & 4 ? half : 0};
+				split(child++, points, order, scratch, first + start[o], first + start[o + 1], childCorner, half, depth + 1);
+			}
+		}
+
+		//visits the points of the leaves whose bounds are closer than queryRadius to point
+		template <typename Visitor>
+		void forEachNeighbor(glm::vec3 point, IgnoredPoints ignore, Visitor&& visit) {
+			const auto radius2 = queryRadius * queryRadius;
+			std::uint32_t stack[8 * maxDepth + 8];
+			std::size_t size = 0;
+			stack[size++] = 0;
+			while (size > 0) {
+				const auto& node = nodes[stack[--size]];
+				if (distance2ToBox(point, node.lower, node.upper) >= radius2)
+					continue;
+				if (node.childCount == 0) {
+					visitRange(node.first, node.last, point, ignore, visit);
+					continue;
+				}
+				for (auto c = node.childCount; c-- > 0;)
+					stack[size++] = node.firstChild + c;
+			}
+		}
+
+		using SpatialIndex::forEachNeighbor;
+
+		std::vector<Node> nodes;
+	};
+}
+
+#endif
@@ -0,0 +1,459 @@
+#include "Simd.h"
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+//the vector kernels are compiled with per-function target attributes and only called after checking the cpu at runtime.
+//gcc does not realign the stack for 32 byte spills on 64 bit windows, so avx2 stays off with mingw
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BPA_SIMD_X86 1
+#include <immintrin.h>
+#if !defined(__MINGW32__)
+#define BPA_SIMD_AVX2 1
+#endif
+#endif
+
+namespace BPA {
+
+	auto withinRadiusScalar(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t {
+		std::size_t n = 0;
+		for (auto i = first; i < last; i++) {
+			const auto dx = positions.x[i] - center.x;
+			const auto dy = positions.y[i] - center.y;
+			const auto dz = positions.z[i] - center.z;
+			out[n] = i;
+			n += (dx * dx + dy * dy) + dz * dz < radius2;
+		}
+		return n;
+	}
+
+#ifdef BPA_SIMD_X86
+	__attribute__((target("sse2")))
+	auto withinRadiusSse2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t {
+		const auto cx = _mm_set1_ps(center.x);
+		const auto cy = _mm_set1_ps(center.y);
+		const auto cz = _mm_set1_ps(center.z);
+		const auto r2 = _mm_set1_ps(radius2);
+		std::size_t n = 0;
+		auto i = first;
+		for (; i + 4 <= last; i += 4) {
+			const auto dx = _mm_sub_ps(_mm_loadu_ps(positions.x + i), cx);
+			const auto dy = _mm_sub_ps(_mm_loadu_ps(positions.y + i), cy);
+			const auto dz = _mm_sub_ps(_mm_loadu_ps(positions.z + i), cz);
+			const auto d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			const auto mask = _mm_movemask_ps(_mm_cmplt_ps(d2, r2));
+			for (std::uint32_t lane = 0; lane < 4; lane++) {
+				out[n] = i + lane;
+				n += (mask >> lane) & 1;
+			}
+		}
+		return n + withinRadiusScalar(positions, i, last, center, radius2, out + n);
+	}
+#else
+	auto withinRadiusSse2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t {
+		return withinRadiusScalar(positions, first, last, center, radius2, out);
+	}
+#endif
+
+#ifdef BPA_SIMD_AVX2
+	//for every 8 bit mask the positions of its set bits, packed into nibbles from the lowest one up
+	constexpr auto makeLeftPackTable() {
+		std::array<std::uint32_t, 256> table{};
+		for (std::uint32_t mask = 0; mask < 256; mask++) {
+			std::uint32_t packed = 0;
+			std::uint32_t count = 0;
+			for (std::uint32_t bit = 0; bit < 8; bit++)
+				if (mask & (1u << bit))
+					packed |= bit << (4 * count++);
+			table[mask] = packed;
+		}
+		return table;
+	}
+	constexpr auto leftPackTable = makeLeftPackTable();
+
+	__attribute__((target("avx2")))
+	auto withinRadiusAvx2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t {
+		const auto cx = _mm256_set1_ps(center.x);
+		const auto cy = _mm256_set1_ps(center.y);
+		const auto cz = _mm256_set1_ps(center.z);
+		const auto r2 = _mm256_set1_ps(radius2);
+		const auto nibbleShifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+		const auto nibble = _mm256_set1_epi32(7);
+		std::size_t n = 0;
+		auto i = first;
+		for (; i + 8 <= last; i += 8) {
+			const auto dx = _mm256_sub_ps(_mm256_loadu_ps(positions.x + i), cx);
+			const auto dy = _mm256_sub_ps(_mm256_loadu_ps(positions.y + i), cy);
+			const auto dz = _mm256_sub_ps(_mm256_loadu_ps(positions.z + i), cz);
+			const auto d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			const auto mask = _mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ));
+			//left pack the indices of the hits and store all 8 lanes, only the first popcount(mask) of them count
+			const auto lanes = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(leftPackTable[mask])), nibbleShifts), nibble);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + n), _mm256_add_epi32(lanes, _mm256_set1_epi32(static_cast<int>(i))));
+			n += __builtin_popcount(mask);
+		}
+		return n + withinRadiusScalar(positions, i, last, center, radius2, out + n);
+	}
+#else
+	auto withinRadiusAvx2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t {
+		return withinRadiusSse2(positions, first, last, center, radius2, out);
+	}
+#endif
+
+	auto anyWithinRadiusScalar(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool {
+		for (auto i = first; i < last; i++) {
+			const auto dx = positions.x[i] - center.x;
+			const auto dy = positions.y[i] - center.y;
+			const auto dz = positions.z[i] - center.z;
+			if ((dx * dx + dy * dy) + dz * dz < radius2)
+				return true;
+		}
+		return false;
+	}
+
+#ifdef BPA_SIMD_X86
+	__attribute__((target("sse2")))
+	auto anyWithinRadiusSse2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool {
+		const auto cx = _mm_set1_ps(center.x);
+		const auto cy = _mm_set1_ps(center.y);
+		const auto cz = _mm_set1_ps(center.z);
+		const auto r2 = _mm_set1_ps(radius2);
+		auto i = first;
+		for (; i + 4 <= last; i += 4) {
+			const auto dx = _mm_sub_ps(_mm_loadu_ps(positions.x + i), cx);
+			const auto dy = _mm_sub_ps(_mm_loadu_ps(positions.y + i), cy);
+			const auto dz = _mm_sub_ps(_mm_loadu_ps(positions.z + i), cz);
+			const auto d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			if (_mm_movemask_ps(_mm_cmplt_ps(d2, r2)))
+				return true;
+		}
+		return anyWithinRadiusScalar(positions, i, last, center, radius2);
+	}
+#else
+	auto anyWithinRadiusSse2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool {
+		return anyWithinRadiusScalar(positions, first, last, center, radius2);
+	}
+#endif
+
+#ifdef BPA_SIMD_AVX2
+	__attribute__((target("avx2")))
+	auto anyWithinRadiusAvx2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool {
+		const auto cx = _mm256_set1_ps(center.x);
+		const auto cy = _mm256_set1_ps(center.y);
+		const auto cz = _mm256_set1_ps(center.z);
+		const auto r2 = _mm256_set1_ps(radius2);
+		auto i = first;
+		for (; i + 8 <= last; i += 8) {
+			const auto dx = _mm256_sub_ps(_mm256_loadu_ps(positions.x + i), cx);
+			const auto dy = _mm256_sub_ps(_mm256_loadu_ps(positions.y + i), cy);
+			const auto dz = _mm256_sub_ps(_mm256_loadu_ps(positions.z + i), cz);
+			const auto d2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			if (_mm256_movemask_ps(_mm256_cmp_ps(d2, r2, _CMP_LT_OQ)))
+				return true;
+		}
+		return anyWithinRadiusScalar(positions, i, last, center, radius2);
+	}
+#else
+	auto anyWithinRadiusAvx2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool {
+		return anyWithinRadiusSse2(positions, first, last, center, radius2);
+	}
+#endif
+
+	//the constants of one pivot, shared by all its candidates
+	struct PivotConstants {
+		glm::vec3 ab;
+		float ab2;
+		float radius2;
+	};
+
+	auto pivotConstants(const PivotEdge& edge) -> PivotConstants {
+		const auto ab = edge.a - edge.b;
+		return {ab, (ab.x * ab.x + ab.y * ab.y) + ab.z * ab.z, edge.radius * edge.radius};
+	}
+
+	//the ball and key of candidate i. all kernels evaluate the same expressions in the same order, so they agree to the bit:
+	//n = ab x ac is the normal of the face (b, a, p), the circumcenter is b + (n x ab |ac|^2 + ac x n |ab|^2) / (2 |n|^2) and the
+	//ball center lies the height above it along n. the key is 1 - cos of the angle between the old and the new center direction,
+	//plus 2 when the ball turns backwards around the edge, so it orders the candidates like the angle does
+	auto pivotOne(const PivotEdge& edge, const PivotConstants& k, SoAPivotCandidates candidates, std::uint32_t i, SoAPivotBalls balls) -> float {
+		const auto& ab = k.ab;
+		const auto acx = candidates.x[i] - edge.b.x;
+		const auto acy = candidates.y[i] - edge.b.y;
+		const auto acz = candidates.z[i] - edge.b.z;
+		const auto nx = ab.y * acz - ab.z * acy;
+		const auto ny = ab.z * acx - ab.x * acz;
+		const auto nz = ab.x * acy - ab.y * acx;
+		const auto n2 = (nx * nx + ny * ny) + nz * nz;
+		const auto normalSide = (nx * candidates.normalX[i] + ny * candidates.normalY[i]) + nz * candidates.normalZ[i];
+		const auto ac2 = (acx * acx + acy * acy) + acz * acz;
+		const auto denominator = n2 + n2;
+		const auto tx = ((ny * ab.z - nz * ab.y) * ac2 + (acy * nz - acz * ny) * k.ab2) / denominator;
+		const auto ty = ((nz * ab.x - nx * ab.z) * ac2 + (acz * nx - acx * nz) * k.ab2) / denominator;
+		const auto tz = ((nx * ab.y - ny * ab.x) * ac2 + (acx * ny - acy * nx) * k.ab2) / denominator;
+		const auto height2 = k.radius2 - ((tx * tx + ty * ty) + tz * tz);
+		const auto height = std::sqrt(height2) / std::sqrt(n2);
+		const auto cx = (edge.b.x + tx) + nx * height;
+		const auto cy = (edge.b.y + ty) + ny * height;
+		const auto cz = (edge.b.z + tz) + nz * height;
+		const auto vx = cx - edge.middle.x;
+		const auto vy = cy - edge.middle.y;
+		const auto vz = cz - edge.middle.z;
+		const auto centerSide = (vx * nx + vy * ny) + vz * nz;
+		const auto v2 = (vx * vx + vy * vy) + vz * vz;
+		const auto& o = edge.oldCenterDirection;
+		const auto cosine = ((o.x * vx + o.y * vy) + o.z * vz) / std::sqrt(v2);
+		const auto turn = ((vy * o.z - vz * o.y) * ab.x + (vz * o.x - vx * o.z) * ab.y) + (vx * o.y - vy * o.x) * ab.z;
+		const auto key = (1.0f - cosine) + (turn < 0 ? 2.0f : 0.0f);
+		balls.x[i] = cx;
+		balls.y[i] = cy;
+		balls.z[i] = cz;
+		//a NaN side does not reject, like in the scalar pivot the kernels replace
+		const auto valid = !(normalSide < 0) && height2 >= 0 && !(centerSide < 0);
+		balls.key[i] = valid ? key : std::numeric_limits<float>::infinity();
+		return balls.key[i];
+	}
+
+	//pivots the candidates [first, count) and keeps the smallest key in best and bestKey
+	void pivotRangeScalar(const PivotEdge& edge, const PivotConstants& k, SoAPivotCandidates candidates, std::uint32_t first, std::uint32_t count,
+		SoAPivotBalls balls, std::uint32_t& best, float& bestKey) {
+		for (auto i = first; i < count; i++) {
+			const auto key = pivotOne(edge, k, candidates, i, balls);
+			if (key < bestKey) {
+				bestKey = key;
+				best = i;
+			}
+		}
+	}
+
+	auto pivotScalar(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t {
+		auto best = count;
+		auto bestKey = std::numeric_limits<float>::infinity();
+		pivotRangeScalar(edge, pivotConstants(edge), candidates, 0, count, balls, best, bestKey);
+		return best;
+	}
+
+	auto smallestKey(const float* keys, std::uint32_t count) -> std::uint32_t {
+		auto best = count;
+		auto bestKey = std::numeric_limits<float>::infinity();
+		for (std::uint32_t i = 0; i < count; i++) {
+			if (keys[i] < bestKey) {
+				bestKey = keys[i];
+				best = i;
+			}
+		}
+		return best;
+	}
+
+	//merges the per lane minima of a vector kernel: the smallest key, of equal keys the lowest index
+	template <std::size_t lanes>
+	void mergeLanes(const std::array<float, lanes>& keys, const std::array<std::int32_t, lanes>& indices, std::uint32_t& best, float& bestKey) {
+		for (std::size_t lane = 0; lane < lanes; lane++) {
+			const auto index = static_cast<std::uint32_t>(indices[lane]);
+			if (keys[lane] < bestKey || (keys[lane] == bestKey && index < best)) {
+				bestKey = keys[lane];
+				best = index;
+			}
+		}
+	}
+
+#ifdef BPA_SIMD_X86
+	__attribute__((target("sse2")))
+	auto pivotSse2(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t {
+		const auto k = pivotConstants(edge);
+		const auto abx = _mm_set1_ps(k.ab.x), aby = _mm_set1_ps(k.ab.y), abz = _mm_set1_ps(k.ab.z);
+		const auto ab2 = _mm_set1_ps(k.ab2);
+		const auto radius2 = _mm_set1_ps(k.radius2);
+		const auto bx = _mm_set1_ps(edge.b.x), by = _mm_set1_ps(edge.b.y), bz = _mm_set1_ps(edge.b.z);
+		const auto mx = _mm_set1_ps(edge.middle.x), my = _mm_set1_ps(edge.middle.y), mz = _mm_set1_ps(edge.middle.z);
+		const auto ox = _mm_set1_ps(edge.oldCenterDirection.x), oy = _mm_set1_ps(edge.oldCenterDirection.y), oz = _mm_set1_ps(edge.oldCenterDirection.z);
+		const auto zero = _mm_setzero_ps();
+		const auto one = _mm_set1_ps(1.0f);
+		const auto two = _mm_set1_ps(2.0f);
+		const auto infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+		auto bestKeys = infinity;
+		auto bestIndices = _mm_set1_epi32(static_cast<int>(count));
+		auto indices = _mm_setr_epi32(0, 1, 2, 3);
+		std::uint32_t i = 0;
+		for (; i + 4 <= count; i += 4, indices = _mm_add_epi32(indices, _mm_set1_epi32(4))) {
+			const auto acx = _mm_sub_ps(_mm_loadu_ps(candidates.x + i), bx);
+			const auto acy = _mm_sub_ps(_mm_loadu_ps(candidates.y + i), by);
+			const auto acz = _mm_sub_ps(_mm_loadu_ps(candidates.z + i), bz);
+			const auto nx = _mm_sub_ps(_mm_mul_ps(aby, acz), _mm_mul_ps(abz, acy));
+			const auto ny = _mm_sub_ps(_mm_mul_ps(abz, acx), _mm_mul_ps(abx, acz));
+			const auto nz = _mm_sub_ps(_mm_mul_ps(abx, acy), _mm_mul_ps(aby, acx));
+			const auto n2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz));
+			const auto normalSide = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(candidates.normalX + i)), _mm_mul_ps(ny, _mm_loadu_ps(candidates.normalY + i))),
+				_mm_mul_ps(nz, _mm_loadu_ps(candidates.normalZ + i)));
+			const auto ac2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(acx, acx), _mm_mul_ps(acy, acy)), _mm_mul_ps(acz, acz));
+			const auto denominator = _mm_add_ps(n2, n2);
+			const auto tx = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ny, abz), _mm_mul_ps(nz, aby)), ac2), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(acy, nz), _mm_mul_ps(acz, ny)), ab2)), denominator);
+			const auto ty = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nz, abx), _mm_mul_ps(nx, abz)), ac2), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(acz, nx), _mm_mul_ps(acx, nz)), ab2)), denominator);
+			const auto tz = _mm_div_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(nx, aby), _mm_mul_ps(ny, abx)), ac2), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(acx, ny), _mm_mul_ps(acy, nx)), ab2)), denominator);
+			const auto height2 = _mm_sub_ps(radius2, _mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, tx), _mm_mul_ps(ty, ty)), _mm_mul_ps(tz, tz)));
+			const auto height = _mm_div_ps(_mm_sqrt_ps(height2), _mm_sqrt_ps(n2));
+			const auto cx = _mm_add_ps(_mm_add_ps(bx, tx), _mm_mul_ps(nx, height));
+			const auto cy = _mm_add_ps(_mm_add_ps(by, ty), _mm_mul_ps(ny, height));
+			const auto cz = _mm_add_ps(_mm_add_ps(bz, tz), _mm_mul_ps(nz, height));
+			const auto vx = _mm_sub_ps(cx, mx);
+			const auto vy = _mm_sub_ps(cy, my);
+			const auto vz = _mm_sub_ps(cz, mz);
+			const auto centerSide = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, nx), _mm_mul_ps(vy, ny)), _mm_mul_ps(vz, nz));
+			const auto v2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+			const auto cosine = _mm_div_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, vx), _mm_mul_ps(oy, vy)), _mm_mul_ps(oz, vz)), _mm_sqrt_ps(v2));
+			const auto turn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(vy, oz), _mm_mul_ps(vz, oy)), abx), _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(vz, ox), _mm_mul_ps(vx, oz)), aby)),
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(vx, oy), _mm_mul_ps(vy, ox)), abz));
+			const auto key = _mm_add_ps(_mm_sub_ps(one, cosine), _mm_and_ps(_mm_cmplt_ps(turn, zero), two));
+			const auto valid = _mm_and_ps(_mm_and_ps(_mm_cmpnlt_ps(normalSide, zero), _mm_cmpge_ps(height2, zero)), _mm_cmpnlt_ps(centerSide, zero));
+			const auto validKey = _mm_or_ps(_mm_and_ps(valid, key), _mm_andnot_ps(valid, infinity));
+			_mm_storeu_ps(balls.x + i, cx);
+			_mm_storeu_ps(balls.y + i, cy);
+			_mm_storeu_ps(balls.z + i, cz);
+			_mm_storeu_ps(balls.key + i, validKey);
+			//every lane keeps its first smallest key
+			const auto smaller = _mm_cmplt_ps(validKey, bestKeys);
+			bestKeys = _mm_or_ps(_mm_and_ps(smaller, validKey), _mm_andnot_ps(smaller, bestKeys));
+			bestIndices = _mm_or_si128(_mm_and_si128(_mm_castps_si128(smaller), indices), _mm_andnot_si128(_mm_castps_si128(smaller), bestIndices));
+		}
+		std::array<float, 4> laneKeys;
+		std::array<std::int32_t, 4> laneIndices;
+		_mm_storeu_ps(laneKeys.data(), bestKeys);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(laneIndices.data()), bestIndices);
+		auto best = count;
+		auto bestKey = std::numeric_limits<float>::infinity();
+		mergeLanes(laneKeys, laneIndices, best, bestKey);
+		pivotRangeScalar(edge, k, candidates, i, count, balls, best, bestKey);
+		return best;
+	}
+#else
+	auto pivotSse2(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t {
+		return pivotScalar(edge, candidates, count, balls);
+	}
+#endif
+
+#ifdef BPA_SIMD_AVX2
+	__attribute__((target("avx2")))
+	auto pivotAvx2(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t {
+		const auto k = pivotConstants(edge);
+		const auto abx = _mm256_set1_ps(k.ab.x), aby = _mm256_set1_ps(k.ab.y), abz = _mm256_set1_ps(k.ab.z);
+		const auto ab2 = _mm256_set1_ps(k.ab2);
+		const auto radius2 = _mm256_set1_ps(k.radius2);
+		const auto bx = _mm256_set1_ps(edge.b.x), by = _mm256_set1_ps(edge.b.y), bz = _mm256_set1_ps(edge.b.z);
+		const auto mx = _mm256_set1_ps(edge.middle.x), my = _mm256_set1_ps(edge.middle.y), mz = _mm256_set1_ps(edge.middle.z);
+		const auto ox = _mm256_set1_ps(edge.oldCenterDirection.x), oy = _mm256_set1_ps(edge.oldCenterDirection.y), oz = _mm256_set1_ps(edge.oldCenterDirection.z);
+		const auto zero = _mm256_setzero_ps();
+		const auto one = _mm256_set1_ps(1.0f);
+		const auto two = _mm256_set1_ps(2.0f);
+		const auto infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+		auto bestKeys = infinity;
+		auto bestIndices = _mm256_set1_epi32(static_cast<int>(count));
+		auto indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		std::uint32_t i = 0;
+		for (; i + 8 <= count; i += 8, indices = _mm256_add_epi32(indices, _mm256_set1_epi32(8))) {
+			const auto acx = _mm256_sub_ps(_mm256_loadu_ps(candidates.x + i), bx);
+			const auto acy = _mm256_sub_ps(_mm256_loadu_ps(candidates.y + i), by);
+			const auto acz = _mm256_sub_ps(_mm256_loadu_ps(candidates.z + i), bz);
+			const auto nx = _mm256_sub_ps(_mm256_mul_ps(aby, acz), _mm256_mul_ps(abz, acy));
+			const auto ny = _mm256_sub_ps(_mm256_mul_ps(abz, acx), _mm256_mul_ps(abx, acz));
+			const auto nz = _mm256_sub_ps(_mm256_mul_ps(abx, acy), _mm256_mul_ps(aby, acx));
+			const auto n2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz));
+			const auto normalSide = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(candidates.normalX + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(candidates.normalY + i))),
+				_mm256_mul_ps(nz, _mm256_loadu_ps(candidates.normalZ + i)));
+			const auto ac2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(acx, acx), _mm256_mul_ps(acy, acy)), _mm256_mul_ps(acz, acz));
+			const auto denominator = _mm256_add_ps(n2, n2);
+			const auto tx = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(ny, abz), _mm256_mul_ps(nz, aby)), ac2), _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(acy, nz), _mm256_mul_ps(acz, ny)), ab2)), denominator);
+			const auto ty = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(nz, abx), _mm256_mul_ps(nx, abz)), ac2), _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(acz, nx), _mm256_mul_ps(acx, nz)), ab2)), denominator);
+			const auto tz = _mm256_div_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(nx, aby), _mm256_mul_ps(ny, abx)), ac2), _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(acx, ny), _mm256_mul_ps(acy, nx)), ab2)), denominator);
+			const auto height2 = _mm256_sub_ps(radius2, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(tx, tx), _mm256_mul_ps(ty, ty)), _mm256_mul_ps(tz, tz)));
+			const auto height = _mm256_div_ps(_mm256_sqrt_ps(height2), _mm256_sqrt_ps(n2));
+			const auto cx = _mm256_add_ps(_mm256_add_ps(bx, tx), _mm256_mul_ps(nx, height));
+			const auto cy = _mm256_add_ps(_mm256_add_ps(by, ty), _mm256_mul_ps(ny, height));
+			const auto cz = _mm256_add_ps(_mm256_add_ps(bz, tz), _mm256_mul_ps(nz, height));
+			const auto vx = _mm256_sub_ps(cx, mx);
+			const auto vy = _mm256_sub_ps(cy, my);
+			const auto vz = _mm256_sub_ps(cz, mz);
+			const auto centerSide = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, nx), _mm256_mul_ps(vy, ny)), _mm256_mul_ps(vz, nz));
+			const auto v2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+			const auto cosine = _mm256_div_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ox, vx), _mm256_mul_ps(oy, vy)), _mm256_mul_ps(oz, vz)), _mm256_sqrt_ps(v2));
+			const auto turn = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(vy, oz), _mm256_mul_ps(vz, oy)), abx), _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(vz, ox), _mm256_mul_ps(vx, oz)), aby)),
+				_mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(vx, oy), _mm256_mul_ps(vy, ox)), abz));
+			const auto key = _mm256_add_ps(_mm256_sub_ps(one, cosine), _mm256_and_ps(_mm256_cmp_ps(turn, zero, _CMP_LT_OQ), two));
+			const auto valid = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(normalSide, zero, _CMP_NLT_UQ), _mm256_cmp_ps(height2, zero, _CMP_GE_OQ)), _mm256_cmp_ps(centerSide, zero, _CMP_NLT_UQ));
+			const auto validKey = _mm256_blendv_ps(infinity, key, valid);
+			_mm256_storeu_ps(balls.x + i, cx);
+			_mm256_storeu_ps(balls.y + i, cy);
+			_mm256_storeu_ps(balls.z + i, cz);
+			_mm256_storeu_ps(balls.key + i, validKey);
+			//every lane keeps its first smallest key
+			const auto smaller = _mm256_cmp_ps(validKey, bestKeys, _CMP_LT_OQ);
+			bestKeys = _mm256_blendv_ps(bestKeys, validKey, smaller);
+			bestIndices = _mm256_blendv_epi8(bestIndices, indices, _mm256_castps_si256(smaller));
+		}
+		std::array<float, 8> laneKeys;
+		std::array<std::int32_t, 8> laneIndices;
+		_mm256_storeu_ps(laneKeys.data(), bestKeys);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(laneIndices.data()), bestIndices);
+		auto best = count;
+		auto bestKey = std::numeric_limits<float>::infinity();
+		mergeLanes(laneKeys, laneIndices, best, bestKey);
+		pivotRangeScalar(edge, k, candidates, i, count, balls, best, bestKey);
+		return best;
+	}
+#else
+	auto pivotAvx2(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t {
+		return pivotSse2(edge, candidates, count, balls);
+	}
+#endif
+
+	auto detectSimdLevel() -> SimdLevel {
+#ifdef BPA_SIMD_X86
+		__builtin_cpu_init();
+#ifdef BPA_SIMD_AVX2
+		if (__builtin_cpu_supports("avx2"))
+			return SimdLevel::avx2;
+#endif
+		if (__builtin_cpu_supports("sse2"))
+			return SimdLevel::sse2;
+#endif
+		return SimdLevel::scalar;
+	}
+
+	auto withinRadiusKernel(SimdLevel level) -> WithinRadiusKernel {
+		switch (level) {
+			case SimdLevel::avx2: return withinRadiusAvx2;
+			case SimdLevel::sse2: return withinRadiusSse2;
+			default: return withinRadiusScalar;
+		}
+	}
+
+	auto withinRadiusKernel() -> WithinRadiusKernel {
+		static const auto kernel = withinRadiusKernel(detectSimdLevel());
+		return kernel;
+	}
+
+	auto anyWithinRadiusKernel(SimdLevel level) -> AnyWithinRadiusKernel {
+		switch (level) {
+			case SimdLevel::avx2: return anyWithinRadiusAvx2;
+			case SimdLevel::sse2: return anyWithinRadiusSse2;
+			default: return anyWithinRadiusScalar;
+		}
+	}
+
+	auto anyWithinRadiusKernel() -> AnyWithinRadiusKernel {
+		static const auto kernel = anyWithinRadiusKernel(detectSimdLevel());
+		return kernel;
+	}
+
+	auto pivotKernel(SimdLevel level) -> PivotKernel {
+		switch (level) {
+			case SimdLevel::avx2: return pivotAvx2;
+			case SimdLevel::sse2: return pivotSse2;
+			default: return pivotScalar;
+		}
+	}
+
+	auto pivotKernel() -> PivotKernel {
+		static const auto kernel = pivotKernel(detectSimdLevel());
+		return kernel;
+	}
+}
@@ -0,0 +1,95 @@
+#ifndef BallPivotingSimd
+#define BallPivotingSimd
+
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace BPA {
+
+	//instruction sets the kernels are written for, the best one supported by the running cpu is picked at runtime
+	enum class SimdLevel {
+		scalar,
+		sse2,
+		avx2
+	};
+
+	//positions in structure-of-arrays layout, the i-th point is (x[i], y[i], z[i])
+	struct SoAPositions {
+		const float* x;
+		const float* y;
+		const float* z;
+	};
+
+	//writes every index i in [first, last) whose position is closer than sqrt(radius2) to center into out, in increasing order,
+	//and returns how many were written. out needs room for last - first + simdPadding indices, the kernels store whole vectors
+	using WithinRadiusKernel = std::size_t (*)(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out);
+
+	constexpr std::size_t simdPadding = 8;
+
+	auto withinRadiusScalar(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t;
+	auto withinRadiusSse2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t;
+	auto withinRadiusAvx2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2, std::uint32_t* out) -> std::size_t;
+
+	//whether any index i in [first, last) has a position closer than sqrt(radius2) to center. the kernels stop at the first vector
+	//holding one, so a ball with a point inside is usually rejected after a few points
+	using AnyWithinRadiusKernel = bool (*)(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2);
+
+	auto anyWithinRadiusScalar(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool;
+	auto anyWithinRadiusSse2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool;
+	auto anyWithinRadiusAvx2(SoAPositions positions, std::uint32_t first, std::uint32_t last, glm::vec3 center, float radius2) -> bool;
+
+	//the edge (a, b) a ball pivots around, the center of the edge and the unit direction from it to the ball's current center
+	struct PivotEdge {
+		glm::vec3 a;
+		glm::vec3 b;
+		glm::vec3 middle;
+		glm::vec3 oldCenterDirection;
+		float radius;
+	};
+
+	//positions and normals of the pivot candidates in structure-of-arrays layout
+	struct SoAPivotCandidates {
+		const float* x;
+		const float* y;
+		const float* z;
+		const float* normalX;
+		const float* normalY;
+		const float* normalZ;
+	};
+
+	//the ball centers of the pivot candidates and their pivot keys. the key grows with the angle the ball turns to reach the
+	//candidate, so the first candidate hit has the smallest key. it is infinite if the ball cannot touch the candidate
+	struct SoAPivotBalls {
+		float* x;
+		float* y;
+		float* z;
+		float* key;
+	};
+
+	//computes the ball centers and keys of the candidates [0, count) when pivoting around edge, for the face (b, a, candidate).
+	//a candidate is skipped if its normal or the ball is on the other side of the face, or no ball of the radius touches all three
+	//points. returns the candidate with the smallest key, the first one of equal keys, or count if the ball touches none
+	using PivotKernel = std::uint32_t (*)(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls);
+
+	auto pivotScalar(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t;
+	auto pivotSse2(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t;
+	auto pivotAvx2(const PivotEdge& edge, SoAPivotCandidates candidates, std::uint32_t count, SoAPivotBalls balls) -> std::uint32_t;
+
+	//the index of the smallest of the keys [0, count), the first one of equal keys, or count if all are infinite
+	auto smallestKey(const float* keys, std::uint32_t count) -> std::uint32_t;
+
+	auto detectSimdLevel() -> SimdLevel;
+	auto withinRadiusKernel(SimdLevel level) -> WithinRadiusKernel;
+	//the kernel of the best level the cpu supports
+	auto withinRadiusKernel() -> WithinRadiusKernel;
+	auto anyWithinRadiusKernel(SimdLevel level) -> AnyWithinRadiusKernel;
+	//the kernel of the best level the cpu supports
+	auto anyWithinRadiusKernel() -> AnyWithinRadiusKernel;
+	auto pivotKernel(SimdLevel level) -> PivotKernel;
+	//the kernel of the best level the cpu supports
+	auto pivotKernel() -> PivotKernel;
+}
+
+#endif
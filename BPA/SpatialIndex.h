@@ -0,0 +1,149 @@
+#ifndef BallPivotingSpatialIndex
+#define BallPivotingSpatialIndex
+
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "BallPivotingAlgorithm.h"
+#include "Simd.h"
+
+namespace BPA {
+
+	//slot of no point at all
+	constexpr std::uint32_t noPoint = std::numeric_limits<std::uint32_t>::max();
+
+	//slots of up to three points a neighborhood query leaves out, unused entries are noPoint
+	struct IgnoredPoints {
+		std::uint32_t a = noPoint;
+		std::uint32_t b = noPoint;
+		std::uint32_t c = noPoint;
+	};
+
+	//a part of the total space, it is the run of slots [first, last) of the points inside it
+	struct Cell {
+		std::uint32_t first;
+		std::uint32_t last;
+
+		auto size() const -> std::size_t { return last - first; }
+		auto empty() const -> bool { return first == last; }
+		auto contains(std::uint32_t slot) const -> bool { return first <= slot && slot < last; }
+	};
+
+	//the part all spatial indices (Grid, KdTree, Octree) share. an index does not copy the caller's points, it puts their
+	//indices into an order of its own, in which every cell (a grid cell, a tree leaf) is a contiguous run of slots: the point
+	//in slot i is input[ids[i]], the cell in slot s owns the slots [cellStart[s], cellStart[s + 1]). the reconstruction refers
+	//to the points by slot, so the mutable state of the points can live in plain arrays indexed by slot.
+	//the index type implements forEachNeighbor(point, ignore, visit), which calls visit(slot) for every point closer than
+	//queryRadius to point except the ignored ones. the reconstruction is a template over the index type
+	template <typename Index>
+	struct SpatialIndex {
+		auto cellCount() const -> std::uint32_t {
+			return static_cast<std::uint32_t>(cellStart.size() - 1);
+		}
+
+		auto cell(std::uint32_t i) const -> Cell {
+			return {cellStart[i], cellStart[i + 1]};
+		}
+
+		auto size() const -> std::uint32_t {
+			return static_cast<std::uint32_t>(ids.size());
+		}
+
+		auto position(std::uint32_t slot) const -> glm::vec3 {
+			return {xs[slot], ys[slot], zs[slot]};
+		}
+
+		auto normal(std::uint32_t slot) const -> glm::vec3 {
+			return (*input)[ids[slot]].normal;
+		}
+
+		//the index of the point in slot in the input
+		auto inputIndex(std::uint32_t slot) const -> std::uint32_t {
+			return ids[slot];
+		}
+
+		//lets the queries reach the neighborhoods of a ball of another radius, the points keep their slots. the trees only
+		//need the query radius, the grid also widens its stencil
+		void setRadius(float radius) {
+			queryRadius = radius * 2;
+		}
+
+		template <typename Visitor>
+		void forEachNeighbor(glm::vec3 point, Visitor&& visit) {
+			static_cast<Index&>(*this).forEachNeighbor(point, IgnoredPoints{}, visit);
+		}
+
+		//fills result with the slots of the points closer than queryRadius to point, except the ignored ones.
+		//result is cleared first but keeps its capacity, so a buffer reused across queries stops allocating
+		void sphericalNeighborhood(glm::vec3 point, IgnoredPoints ignore, std::vector<std::uint32_t>& result) {
+			result.clear();
+			static_cast<Index&>(*this).forEachNeighbor(point, ignore, [&](std::uint32_t slot) { result.push_back(slot); });
+		}
+
+		//the same, returning a new vector. the query fills a buffer of the thread, whose capacity is kept across queries, and the
+		//result is copied out of it, so a query allocates once, with the exact size, instead of once per growth of the result
+		auto sphericalNeighborhood(glm::vec3 point, IgnoredPoints ignore) -> std::vector<std::uint32_t> {
+			static thread_local std::vector<std::uint32_t> buffer;
+			sphericalNeighborhood(point, ignore, buffer);
+			return {begin(buffer), end(buffer)};
+		}
+
+		//the input and the slot order are in place: keeps the input and fills the structure-of-arrays copy of the positions in
+		//slot order, the only per point data an index holds besides ids. the distance kernel streams through it
+		void storePositions(const std::vector<Point>& points) {
+			input = &points;
+			xs.resize(ids.size());
+			ys.resize(ids.size());
+			zs.resize(ids.size());
+			for (std::size_t i = 0; i < ids.size(); i++) {
+				xs[i] = points[ids[i]].pos.x;
+				ys[i] = points[ids[i]].pos.y;
+				zs[i] = points[ids[i]].pos.z;
+			}
+		}
+
+		//visits the points in the slots [first, last) closer than queryRadius to point, except the ignored ones.
+		//the distances are tested by the vector kernel on the structure-of-arrays positions, a chunk at a time,
+		//then the ignored slots are masked out without branches
+		template <typename Visitor>
+		void visitRange(std::uint32_t first, std::uint32_t last, glm::vec3 point, IgnoredPoints ignore, Visitor& visit) {
+			constexpr std::uint32_t chunk = 64;
+			std::uint32_t hits[chunk + simdPadding];
+			const SoAPositions positions{xs.data(), ys.data(), zs.data()};
+			for (; first < last; first += chunk) {
+				const auto count = withinRadius(positions, first, std::min(first + chunk, last), point, queryRadius * queryRadius, hits);
+				std::size_t kept = 0;
+				for (std::size_t i = 0; i < count; i++) {
+					const auto slot = hits[i];
+					hits[kept] = slot;
+					kept += (slot != ignore.a) & (slot != ignore.b) & (slot != ignore.c);
+				}
+				for (std::size_t i = 0; i < kept; i++)
+					visit(hits[i]);
+			}
+		}
+
+		//the caller's points, they have to outlive the index
+		const std::vector<Point>* input = nullptr;
+		std::vector<std::uint32_t> ids;
+		std::vector<std::uint32_t> cellStart;
+		//copy of the positions in structure-of-arrays layout for the distance kernel
+		std::vector<float> xs;
+		std::vector<float> ys;
+		std::vector<float> zs;
+		float queryRadius = 0;
+		WithinRadiusKernel withinRadius = withinRadiusKernel();
+	};
+
+	//squared distance from point to the box [lower, upper], 0 inside
+	inline auto distance2ToBox(glm::vec3 point, glm::vec3 lower, glm::vec3 upper) -> float {
+		const auto d = glm::max(glm::max(lower - point, point - upper), glm::vec3{0});
+		return glm::dot(d, d);
+	}
+}
+
+#endif
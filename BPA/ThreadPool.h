@@ -0,0 +1,196 @@
+#ifndef BallPivotingThreadPool
+#define BallPivotingThreadPool
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BallPivotingAlgorithm.h"
+
+namespace BPA {
+
+	//a fixed set of worker threads running parallel loops, the calling thread takes part in every loop
+	struct ThreadPool {
+		//threads is the total number of threads including the caller, 0 uses all hardware threads
+		explicit ThreadPool(unsigned threads = 0) {
+			if (threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			for (unsigned i = 1; i < threads; i++)
+				workers.emplace_back([this] { work(); });
+		}
+
+		~ThreadPool() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stopping = true;
+			}
+			wake.notify_all();
+			for (auto& w : workers)
+				w.join();
+		}
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		auto size() const -> unsigned {
+			return static_cast<unsigned>(workers.size() + 1);
+		}
+
+		//calls f(i) for every i in [0, count) and returns when all calls are done. the indices are handed out one by one,
+		//so every call should be a block of work of its own
+		void parallelFor(std::size_t count, const std::function<void(std::size_t)>& f) {
+			if (workers.empty() || count <= 1) {
+				for (std::size_t i = 0; i < count; i++)
+					f(i);
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &f;
+				jobSize = count;
+				next = 0;
+				busy = workers.size();
+				generation++;
+			}
+			wake.notify_all();
+			runJob(f, count);
+			std::unique_lock<std::mutex> lock(mutex);
+			done.wait(lock, [&] { return busy == 0; });
+			job = nullptr;
+		}
+
+		//runs the tasks 0 to count - 1, and every task they spawn, with work stealing and returns what every worker did. every
+		//worker has a deque of tasks of its own, which starts with a contiguous block of the tasks. a worker runs the newest task
+		//of its deque, so a spawned task follows its parent on the same thread, and an idle worker steals the oldest task of
+		//another deque. every deque has a lock of its own, there is none all workers share. a worker finding no task at all
+		//sleeps until a task is spawned or the run is over, a spawn only takes the lock of the sleepers if there are any
+		auto runTasks(std::size_t count, const std::function<void(std::size_t, const std::function<void(std::size_t)>&)>& f) -> std::vector<WorkerStatistics> {
+			struct TaskDeque {
+				std::mutex mutex;
+				std::deque<std::size_t> tasks;
+			};
+			const auto workerCount = std::size_t{size()};
+			std::vector<TaskDeque> deques(workerCount);
+			std::vector<WorkerStatistics> statistics(workerCount);
+			for (std::size_t w = 0; w < workerCount; w++)
+				for (auto t = count * w / workerCount; t < count * (w + 1) / workerCount; t++)
+					deques[w].tasks.push_back(t);
+			//the tasks queued or running, the run is over once there are none
+			std::atomic<std::size_t> pending{count};
+			//the tasks spawned so far and the workers sleeping until there are more
+			std::atomic<std::size_t> spawned{0};
+			std::atomic<std::size_t> sleepers{0};
+			std::mutex idleMutex;
+			std::condition_variable idle;
+			const auto start = std::chrono::steady_clock::now();
+			//every worker loop takes one index, a thread only takes a second one after the run is over
+			parallelFor(workerCount, [&](std::size_t w) {
+				auto& own = deques[w];
+				const std::function<void(std::size_t)> spawn = [&](std::size_t task) {
+					pending++;
+					{
+						std::lock_guard<std::mutex> lock(own.mutex);
+						own.tasks.push_back(task);
+					}
+					spawned++;
+					//a sleeper counts itself before it checks spawned, so either it sees this task or it is counted here, and
+					//holding its lock makes sure it is already waiting when it is notified
+					if (sleepers > 0) {
+						std::lock_guard<std::mutex> lock(idleMutex);
+						idle.notify_one();
+					}
+				};
+				const auto take = [](TaskDeque& deque, bool newest, std::size_t& task) {
+					std::lock_guard<std::mutex> lock(deque.mutex);
+					if (deque.tasks.empty())
+						return false;
+					task = newest ? deque.tasks.back() : deque.tasks.front();
+					if (newest)
+						deque.tasks.pop_back();
+					else
+						deque.tasks.pop_front();
+					return true;
+				};
+				while (pending > 0) {
+					const auto spawnedBefore = spawned.load();
+					std::size_t task;
+					auto found = take(own, true, task);
+					for (std::size_t v = 1; !found && v < workerCount; v++) {
+						found = take(deques[(w + v) % workerCount], false, task);
+						statistics[w].stolen += found;
+					}
+					if (!found) {
+						//the running tasks may still spawn some
+						std::unique_lock<std::mutex> lock(idleMutex);
+						sleepers++;
+						idle.wait(lock, [&] { return spawned != spawnedBefore || pending == 0; });
+						sleepers--;
+						continue;
+					}
+					const auto taskStart = std::chrono::steady_clock::now();
+					f(task, spawn);
+					statistics[w].busySeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - taskStart).count();
+					statistics[w].tasks++;
+					if (--pending == 0) {
+						std::lock_guard<std::mutex> lock(idleMutex);
+						idle.notify_all();
+					}
+				}
+			});
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			for (auto& worker : statistics)
+				worker.seconds = seconds;
+			return statistics;
+		}
+
+	private:
+		void runJob(const std::function<void(std::size_t)>& f, std::size_t count) {
+			for (auto i = next++; i < count; i = next++)
+				f(i);
+		}
+
+		void work() {
+			std::size_t seen = 0;
+			for (;;) {
+				const std::function<void(std::size_t)>* f;
+				std::size_t count;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					wake.wait(lock, [&] { return stopping || generation != seen; });
+					if (stopping)
+						return;
+					seen = generation;
+					f = job;
+					count = jobSize;
+				}
+				runJob(*f, count);
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					busy--;
+				}
+				done.notify_one();
+			}
+		}
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake;
+		std::condition_variable done;
+		const std::function<void(std::size_t)>* job = nullptr;
+		std::size_t jobSize = 0;
+		std::atomic<std::size_t> next{0};
+		std::size_t busy = 0;
+		std::size_t generation = 0;
+		bool stopping = false;
+	};
+}
+
+#endif
@@ -0,0 +1,986 @@
+//benchmarks for the ball pivoting internals, build with -DBPA_BUILD_BENCHMARKS=ON
+//usage: BPA_benchmark [ply file] [radius] [synthetic point count]
+
+#include "BPA/BallPivotingAlgorithm.h"
+#include "BPA/Grid.h"
+#include "BPA/KdTree.h"
+#include "BPA/Octree.h"
+#include "BPA/SeedSearch.h"
+#include "rply/rply.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//every heap allocation of the benchmark is counted, this shows which code paths are allocation free.
+//the live heap bytes and their peak are tracked too, every allocation carries its size in a header in front of it
+std::atomic<std::size_t> allocationCount{0};
+std::atomic<std::size_t> liveHeapBytes{0};
+std::atomic<std::size_t> peakHeapBytes{0};
+
+constexpr std::size_t allocationHeader = alignof(std::max_align_t);
+
+void* operator new(std::size_t size) {
+	allocationCount++;
+	if (auto* p = static_cast<char*>(std::malloc(size + allocationHeader))) {
+		*reinterpret_cast<std::size_t*>(p) = size;
+		const auto live = liveHeapBytes += size;
+		for (auto peak = peakHeapBytes.load(); live > peak && !peakHeapBytes.compare_exchange_weak(peak, live);) {}
+		return p + allocationHeader;
+	}
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept {
+	if (!p)
+		return;
+	//the header is found by address arithmetic, stepping a pointer in front of the block it points to is out of its bounds
+	auto* header = reinterpret_cast<char*>(reinterpret_cast<std::uintptr_t>(p) - allocationHeader);
+	std::size_t size;
+	std::memcpy(&size, header, sizeof size);
+	liveHeapBytes -= size;
+	std::free(header);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+	operator delete(p);
+}
+
+namespace {
+	using Clock = std::chrono::steady_clock;
+
+	auto millisecondsSince(Clock::time_point start) -> double {
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	//the point the legacy grid copies the input into
+	struct LegacyPoint {
+		glm::vec3 pos;
+		glm::vec3 normal;
+		bool used = false;
+		std::vector<BPA::MeshEdge*> edges;
+	};
+
+	//the grid layout before the CSR rewrite, every cell is its own vector of points
+	struct LegacyGrid {
+		LegacyGrid(const std::vector<BPA::Point>& points, float radius)
+			: cellSize(radius * 2) {
+			lower = points.front().pos;
+			upper = points.front().pos;
+			for (const auto& p : points) {
+				lower = glm::min(lower, p.pos);
+				upper = glm::max(upper, p.pos);
+			}
+			dims = glm::max(glm::ivec3{glm::ceil((upper - lower) / cellSize)}, glm::ivec3{1});
+			cells.resize(dims.x * dims.y * dims.z);
+			for (const auto& p : points)
+				cell(cellIndex(p.pos)).push_back({p.pos, p.normal, false, {}});
+		}
+
+		auto cellIndex(glm::vec3 point) -> glm::ivec3 {
+			return glm::clamp(glm::ivec3{(point - lower) / cellSize}, glm::ivec3{}, dims - 1);
+		}
+
+		auto cell(glm::ivec3 index) -> std::vector<LegacyPoint>& {
+			return cells[index.z * dims.x * dims.y + index.y * dims.x + index.x];
+		}
+
+		auto sphericalNeighborhood(glm::vec3 point, std::initializer_list<glm::vec3> ignore) -> std::vector<LegacyPoint*> {
+			std::vector<LegacyPoint*> result;
+			const auto centerIndex = cellIndex(point);
+			result.reserve(cell(centerIndex).size() * 27);
+			for (auto xOff : {-1, 0, 1}) {
+				for (auto yOff : {-1, 0, 1}) {
+					for (auto zOff : {-1, 0, 1}) {
+						const auto index = centerIndex + glm::ivec3{xOff, yOff, zOff};
+						if (index.x < 0 || index.x >= dims.x) continue;
+						if (index.y < 0 || index.y >= dims.y) continue;
+						if (index.z < 0 || index.z >= dims.z) continue;
+						for (auto& p : cell(index))
+							if (glm::length2(p.pos - point) < cellSize * cellSize && std::find(std::begin(ignore), std::end(ignore), p.pos) == std::end(ignore))
+								result.push_back(&p);
+					}
+				}
+			}
+			return result;
+		}
+
+		glm::vec3 lower;
+		glm::vec3 upper;
+		float cellSize;
+		glm::ivec3 dims;
+		std::vector<std::vector<LegacyPoint>> cells;
+	};
+
+	//memory of the cell tables, without the points themselves
+	auto cellTableBytes(const LegacyGrid& grid) -> std::size_t {
+		return grid.cells.capacity() * sizeof(grid.cells[0]);
+	}
+
+	auto cellTableBytes(const BPA::Grid& grid) -> std::size_t {
+		return grid.cellStart.capacity() * sizeof(grid.cellStart[0]) + grid.cellSlot.capacity() * sizeof(grid.cellSlot[0]) +
+			   grid.cellTable.entries.capacity() * sizeof(grid.cellTable.entries[0]);
+	}
+
+	template <typename Tree>
+	auto treeBytes(const Tree& tree) -> std::size_t {
+		return tree.cellStart.capacity() * sizeof(tree.cellStart[0]) + tree.nodes.capacity() * sizeof(tree.nodes[0]);
+	}
+
+	auto cellTableBytes(const BPA::KdTree& tree) -> std::size_t {
+		return treeBytes(tree);
+	}
+
+	auto cellTableBytes(const BPA::Octree& tree) -> std::size_t {
+		return treeBytes(tree);
+	}
+
+	double plyValues[6];
+
+	int vertexCallback(p_ply_argument argument) {
+		std::vector<BPA::Point>* points;
+		long index;
+		ply_get_argument_user_data(argument, (void**)&points, &index);
+		plyValues[index] = ply_get_argument_value(argument);
+		if (index == 5)
+			points->push_back({{plyValues[0], plyValues[1], plyValues[2]}, {plyValues[3], plyValues[4], plyValues[5]}});
+		return 1;
+	}
+
+	auto loadPly(const char* path) -> std::vector<BPA::Point> {
+		std::vector<BPA::Point> points;
+		p_ply input = ply_open(path, nullptr, 0, nullptr);
+		if (!input || !ply_read_header(input))
+			return points;
+		const char* names[] = {"x", "y", "z", "nx", "ny", "nz"};
+		for (long i = 0; i < 6; i++)
+			ply_set_read_cb(input, "vertex", names[i], vertexCallback, &points, i);
+		if (!ply_read(input))
+			points.clear();
+		ply_close(input);
+		return points;
+	}
+
+	//evenly distributed points on a unit sphere (fibonacci lattice), the normals point outwards
+	auto syntheticSphere(std::size_t count) -> std::vector<BPA::Point> {
+		std::vector<BPA::Point> points;
+		points.reserve(count);
+		const auto golden = static_cast<float>(M_PI * (3.0 - std::sqrt(5.0)));
+		for (std::size_t i = 0; i < count; i++) {
+			const auto y = 1.0f - 2.0f * (i + 0.5f) / count;
+			const auto r = std::sqrt(1.0f - y * y);
+			const auto phi = golden * i;
+			const glm::vec3 p{r * std::cos(phi), y, r * std::sin(phi)};
+			points.push_back({p, p});
+		}
+		return points;
+	}
+
+	//radius giving roughly the same neighborhood size on every synthetic sphere
+	auto syntheticRadius(std::size_t count) -> float {
+		return 2.0f * std::sqrt(4.0f * static_cast<float>(M_PI) / count);
+	}
+
+	//uniformly random points in the unit cube, a dense volume with many points per cell
+	auto syntheticCube(std::size_t count) -> std::vector<BPA::Point> {
+		std::mt19937 random{7};
+		std::uniform_real_distribution<float> coordinate{0.0f, 1.0f};
+		std::vector<BPA::Point> points(count);
+		for (auto& p : points) {
+			p.pos = {coordinate(random), coordinate(random), coordinate(random)};
+			p.normal = glm::normalize(p.pos - 0.5f);
+		}
+		return points;
+	}
+
+	//a wall seen by a scanner: points on the plane z = 0 at a log-uniform distance in [0.2, 5] from the scanner's foot point,
+	//so the density falls with the squared distance over almost three orders of magnitude
+	auto syntheticScan(std::size_t count) -> std::vector<BPA::Point> {
+		std::mt19937 random{11};
+		std::uniform_real_distribution<float> logDistance{std::log(0.2f), std::log(5.0f)};
+		std::uniform_real_distribution<float> angle{0.0f, 2.0f * static_cast<float>(M_PI)};
+		std::vector<BPA::Point> points(count);
+		for (auto& p : points) {
+			const auto d = std::exp(logDistance(random));
+			const auto a = angle(random);
+			p.pos = {d * std::cos(a), d * std::sin(a), 0.0f};
+			p.normal = {0.0f, 0.0f, 1.0f};
+		}
+		return points;
+	}
+
+	//four unit spheres side by side with half, a quarter, an eighth and an eighth of the points, so their densities differ
+	auto syntheticClusters(std::size_t count) -> std::vector<BPA::Point> {
+		std::vector<BPA::Point> points;
+		const std::size_t counts[] = {count / 2, count / 4, count / 8, count - count / 2 - count / 4 - count / 8};
+		for (auto i = 0; i < 4; i++)
+			for (const auto& p : syntheticSphere(counts[i]))
+				points.push_back({p.pos + glm::vec3{3.0f * i, 0.0f, 0.0f}, p.normal});
+		return points;
+	}
+
+	//straight wires along x below a unit sphere: three points on a wire are collinear and never make a seed,
+	//so the seed search has to go through all wire cells, which come first in z-y-x order, before it reaches the sphere
+	auto syntheticWires(std::size_t wirePoints, std::size_t spherePoints, float radius) -> std::vector<BPA::Point> {
+		std::vector<BPA::Point> points;
+		const auto spacing = radius / 5;
+		const auto perWire = static_cast<std::size_t>(2.0f / spacing);
+		const auto wiresPerAxis = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<float>(wirePoints / perWire + 1))));
+		for (std::size_t i = 0; i < wirePoints; i++) {
+			const auto wire = i / perWire;
+			const glm::vec3 pos{-1.0f + (i % perWire) * spacing, -1.0f + (wire % wiresPerAxis) * 4 * radius, (wire / wiresPerAxis) * 4 * radius};
+			points.push_back({pos, {0.0f, 0.0f, 1.0f}});
+		}
+		const auto top = (wirePoints / perWire / wiresPerAxis + 1) * 4 * radius;
+		for (const auto& p : syntheticSphere(spherePoints))
+			points.push_back({p.pos + glm::vec3{0.0f, 0.0f, top + 2.0f}, p.normal});
+		return points;
+	}
+
+	//synthetic clouds come out spatially sorted, real scans are not always
+	auto shuffled(std::vector<BPA::Point> points) -> std::vector<BPA::Point> {
+		std::shuffle(begin(points), end(points), std::mt19937{42});
+		return points;
+	}
+
+	//the slot of every input point, the inverse of index.ids. the legacy grid has no slots, its queries ignore by position
+	auto inputSlots(const LegacyGrid& grid) -> std::vector<std::uint32_t> {
+		std::size_t count = 0;
+		for (const auto& c : grid.cells)
+			count += c.size();
+		return std::vector<std::uint32_t>(count, BPA::noPoint);
+	}
+
+	template <typename Index>
+	auto inputSlots(const Index& index) -> std::vector<std::uint32_t> {
+		std::vector<std::uint32_t> slots(index.ids.size());
+		for (std::uint32_t s = 0; s < index.ids.size(); s++)
+			slots[index.ids[s]] = s;
+		return slots;
+	}
+
+	//the query leaves out the query point itself, by position in the legacy grid and by slot in the current one
+	auto neighborhoodOf(LegacyGrid& grid, glm::vec3 point, std::uint32_t) -> std::vector<LegacyPoint*> {
+		return grid.sphericalNeighborhood(point, {point});
+	}
+
+	template <typename Index>
+	auto neighborhoodOf(Index& index, glm::vec3 point, std::uint32_t slot) -> std::vector<std::uint32_t> {
+		return index.sphericalNeighborhood(point, {slot});
+	}
+
+	template <typename Grid>
+	void printQueries(const char* layout, const Grid& grid, std::size_t queries, double buildTime, double queryTime, std::size_t hits, std::size_t allocations) {
+		std::cout << "  " << std::left << std::setw(8) << layout << std::right
+				  << " build " << std::setw(9) << buildTime << " ms"
+				  << "   queries " << std::setw(9) << queries / queryTime * 1000.0 << " /s"
+				  << "   avg hits " << static_cast<double>(hits) / queries
+				  << "   allocs/query " << static_cast<double>(allocations) / queries
+				  << "   cell tables " << cellTableBytes(grid) / 1048576.0 << " MB\n";
+	}
+
+	//queries through the api returning a fresh vector
+	template <typename MakeGrid>
+	void benchmarkGrid(const char* layout, const std::vector<BPA::Point>& points, MakeGrid makeGrid) {
+		const auto buildStart = Clock::now();
+		auto grid = makeGrid();
+		const auto buildTime = millisecondsSince(buildStart);
+
+		std::size_t hits = 0;
+		const auto slots = inputSlots(grid);
+		const auto allocationsBefore = allocationCount.load();
+		const auto queryStart = Clock::now();
+		for (std::uint32_t i = 0; i < points.size(); i++)
+			hits += neighborhoodOf(grid, points[i].pos, slots[i]).size();
+		const auto queryTime = millisecondsSince(queryStart);
+		printQueries(layout, grid, points.size(), buildTime, queryTime, hits, allocationCount - allocationsBefore);
+	}
+
+	//queries filling one reused buffer
+	void benchmarkGridWithBuffer(const char* layout, const std::vector<BPA::Point>& points, float radius) {
+		const auto buildStart = Clock::now();
+		BPA::Grid grid(points, radius, BPA::CellOrder::linear, BPA::GridBackend::dense);
+		const auto buildTime = millisecondsSince(buildStart);
+
+		std::size_t hits = 0;
+		std::vector<std::uint32_t> neighborhood;
+		const auto slots = inputSlots(grid);
+		const auto allocationsBefore = allocationCount.load();
+		const auto queryStart = Clock::now();
+		for (std::uint32_t i = 0; i < points.size(); i++) {
+			grid.sphericalNeighborhood(points[i].pos, {slots[i]}, neighborhood);
+			hits += neighborhood.size();
+		}
+		const auto queryTime = millisecondsSince(queryStart);
+		printQueries(layout, grid, points.size(), buildTime, queryTime, hits, allocationCount - allocationsBefore);
+	}
+
+	void benchmarkGrids(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << "\n";
+		benchmarkGrid("legacy", points, [&] { return LegacyGrid(points, radius); });
+		benchmarkGrid("csr", points, [&] { return BPA::Grid(points, radius, BPA::CellOrder::linear, BPA::GridBackend::dense); });
+		benchmarkGridWithBuffer("buffer", points, radius);
+		benchmarkGrid("morton", points, [&] { return BPA::Grid(points, radius, BPA::CellOrder::morton); });
+		benchmarkGrid("sparse", points, [&] { return BPA::Grid(points, radius, BPA::CellOrder::linear, BPA::GridBackend::sparse); });
+	}
+
+	//neighborhood queries with each distance kernel
+	void benchmarkKernels(const std::string& name, const std::vector<BPA::Point>& points, float radius, std::size_t queries) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", " << queries << " queries\n";
+		BPA::Grid grid(points, radius);
+		const auto detected = BPA::detectSimdLevel();
+		for (const auto& [level, levelName] : {std::pair{BPA::SimdLevel::scalar, "scalar"}, std::pair{BPA::SimdLevel::sse2, "sse2"}, std::pair{BPA::SimdLevel::avx2, "avx2"}}) {
+			if (level > detected)
+				continue;
+			grid.withinRadius = BPA::withinRadiusKernel(level);
+			std::size_t hits = 0;
+			const auto start = Clock::now();
+			for (std::size_t i = 0; i < queries; i++)
+				grid.forEachNeighbor(points[i].pos, [&](std::uint32_t) { hits++; });
+			const auto time = millisecondsSince(start);
+			std::cout << "  " << std::left << std::setw(8) << levelName << std::right
+					  << " queries " << std::setw(9) << queries / time * 1000.0 << " /s"
+					  << "   avg hits " << static_cast<double>(hits) / queries << "\n";
+		}
+	}
+
+	//the pivot candidates of many edges in structure-of-arrays layout, the candidates of edge e are [offsets[e], offsets[e + 1])
+	struct PivotWorkload {
+		std::vector<BPA::PivotEdge> edges;
+		std::vector<std::uint32_t> offsets{0};
+		std::array<std::vector<float>, 6> columns;
+	};
+
+	//an edge from every sampled point to its first neighbor, with the ball above the edge along the point's normal
+	auto pivotWorkload(BPA::Grid& grid, float radius, std::size_t edges) -> PivotWorkload {
+		PivotWorkload work;
+		const auto step = std::max<std::size_t>(1, grid.size() / edges);
+		for (std::uint32_t a = 0; a < grid.size() && work.edges.size() < edges; a += static_cast<std::uint32_t>(step)) {
+			const auto near = grid.sphericalNeighborhood(grid.position(a), {a});
+			if (near.empty())
+				continue;
+			const auto b = near.front();
+			const auto aPos = grid.position(a);
+			const auto bPos = grid.position(b);
+			const auto middle = (aPos + bPos) / 2.0f;
+			work.edges.push_back({aPos, bPos, middle, glm::normalize(grid.normal(a)), radius});
+			for (const auto p : grid.sphericalNeighborhood(middle, {a, b})) {
+				const auto pos = grid.position(p);
+				const auto normal = grid.normal(p);
+				for (std::size_t c = 0; c < 3; c++) {
+					work.columns[c].push_back(pos[static_cast<int>(c)]);
+					work.columns[c + 3].push_back(normal[static_cast<int>(c)]);
+				}
+			}
+			work.offsets.push_back(static_cast<std::uint32_t>(work.columns[0].size()));
+		}
+		return work;
+	}
+
+	//the pivot before the batched kernel: one candidate at a time with computeBallCenter, normalize and acos
+	auto legacyPivot(const BPA::PivotEdge& edge, BPA::SoAPivotCandidates candidates, std::uint32_t count) -> std::uint32_t {
+		auto smallestAngle = std::numeric_limits<float>::max();
+		auto best = count;
+		for (std::uint32_t i = 0; i < count; i++) {
+			const glm::vec3 pos{candidates.x[i], candidates.y[i], candidates.z[i]};
+			const auto newFace = BPA::Triangle{edge.b, edge.a, pos};
+			const auto newFaceNormal = newFace.normal();
+			if (glm::dot(newFaceNormal, glm::vec3{candidates.normalX[i], candidates.normalY[i], candidates.normalZ[i]}) < 0)
+				continue;
+			const auto c = BPA::computeBallCenter(newFace, edge.radius);
+			if (!c)
+				continue;
+			const auto newCenterVec = glm::normalize(c.value() - edge.middle);
+			if (glm::dot(newCenterVec, newFaceNormal) < 0)
+				continue;
+			auto angle = std::acos(std::clamp(glm::dot(edge.oldCenterDirection, newCenterVec), -1.0f, 1.0f));
+			if (glm::dot(glm::cross(newCenterVec, edge.oldCenterDirection), edge.a - edge.b) < 0)
+				angle += static_cast<float>(M_PI);
+			if (angle < smallestAngle) {
+				smallestAngle = angle;
+				best = i;
+			}
+		}
+		return best;
+	}
+
+	//the candidates of pivots around many edges, one at a time with the old loop and batched with each pivot kernel
+	void benchmarkPivotKernels(const std::string& name, const std::vector<BPA::Point>& points, float radius, std::size_t edges) {
+		BPA::Grid grid(points, radius);
+		auto work = pivotWorkload(grid, radius, edges);
+		const auto candidateCount = work.columns[0].size();
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", " << work.edges.size()
+				  << " pivots of " << static_cast<double>(candidateCount) / work.edges.size() << " candidates\n";
+		std::array<std::vector<float>, 4> ballColumns;
+		for (auto& column : ballColumns)
+			column.resize(candidateCount);
+		const auto candidatesOf = [&](std::size_t e) {
+			const auto o = work.offsets[e];
+			return BPA::SoAPivotCandidates{work.columns[0].data() + o, work.columns[1].data() + o, work.columns[2].data() + o,
+				work.columns[3].data() + o, work.columns[4].data() + o, work.columns[5].data() + o};
+		};
+		const auto countOf = [&](std::size_t e) { return work.offsets[e + 1] - work.offsets[e]; };
+
+		//the scalar kernel is the reference the others are compared with
+		std::vector<std::uint32_t> reference(work.edges.size());
+		for (std::size_t e = 0; e < work.edges.size(); e++) {
+			const auto o = work.offsets[e];
+			reference[e] = BPA::pivotScalar(work.edges[e], candidatesOf(e), countOf(e), {ballColumns[0].data() + o, ballColumns[1].data() + o, ballColumns[2].data() + o, ballColumns[3].data() + o});
+		}
+		const auto referenceBalls = ballColumns;
+
+		const auto report = [&](const char* variant, double time, std::size_t agreeing) {
+			std::cout << "  " << std::left << std::setw(8) << variant << std::right
+					  << " candidates " << std::setw(9) << candidateCount / time / 1000.0 << " M/s"
+					  << "   same pivot as scalar " << std::setw(7) << agreeing << " / " << work.edges.size() << "\n";
+		};
+		constexpr auto repeats = 10;
+		{
+			std::size_t agreeing = 0;
+			const auto start = Clock::now();
+			for (auto r = 0; r < repeats; r++)
+				for (std::size_t e = 0; e < work.edges.size(); e++)
+					agreeing += legacyPivot(work.edges[e], candidatesOf(e), countOf(e)) == reference[e];
+			report("legacy", millisecondsSince(start) / repeats, agreeing / repeats);
+		}
+		const auto detected = BPA::detectSimdLevel();
+		for (const auto& [level, levelName] : {std::pair{BPA::SimdLevel::scalar, "scalar"}, std::pair{BPA::SimdLevel::sse2, "sse2"}, std::pair{BPA::SimdLevel::avx2, "avx2"}}) {
+			if (level > detected)
+				continue;
+			const auto pivot = BPA::pivotKernel(level);
+			std::size_t agreeing = 0;
+			const auto start = Clock::now();
+			for (auto r = 0; r < repeats; r++) {
+				for (std::size_t e = 0; e < work.edges.size(); e++) {
+					const auto o = work.offsets[e];
+					agreeing += pivot(work.edges[e], candidatesOf(e), countOf(e), {ballColumns[0].data() + o, ballColumns[1].data() + o, ballColumns[2].data() + o, ballColumns[3].data() + o}) == reference[e];
+				}
+			}
+			const auto time = millisecondsSince(start) / repeats;
+			//bitwise, the balls of rejected candidates may be NaN
+			const auto sameBits = [](const std::vector<float>& a, const std::vector<float>& b) { return std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0; };
+			if (!std::equal(begin(ballColumns), end(ballColumns), begin(referenceBalls), sameBits))
+				std::cout << "  " << levelName << " balls differ from the scalar kernel!!!\n";
+			report(levelName, time, agreeing / repeats);
+		}
+	}
+
+	//the emptiness test before the kernels: any_of over the slots, looking every position up in the index
+	auto legacyBallIsEmpty(glm::vec3 ballCenter, const std::vector<std::uint32_t>& points, const BPA::Grid& grid, float inner2) -> bool {
+		return !std::any_of(begin(points), end(points), [&](std::uint32_t p) {
+			return glm::length2(grid.position(p) - ballCenter) < inner2;
+		});
+	}
+
+	//the emptiness test alone, on balls touching sampled points from outside the surface (mostly empty) and balls sunk halfway
+	//into it (rejected by their own point), each over the neighborhood of its point
+	void benchmarkEmptyBall(const std::string& name, const std::vector<BPA::Point>& points, float radius, std::size_t balls) {
+		BPA::Grid grid(points, radius);
+		std::vector<glm::vec3> centers;
+		std::vector<std::vector<std::uint32_t>> neighborhoods;
+		std::vector<std::uint32_t> offsets{0};
+		std::array<std::vector<float>, 3> columns;
+		const auto step = std::max<std::size_t>(1, grid.size() / balls);
+		for (std::uint32_t a = 0; a < grid.size() && centers.size() < balls; a += static_cast<std::uint32_t>(step)) {
+			const auto pos = grid.position(a);
+			const auto up = glm::normalize(grid.normal(a));
+			centers.push_back(pos + up * (centers.size() % 2 == 0 ? radius : radius / 2));
+			neighborhoods.push_back(grid.sphericalNeighborhood(pos, {}));
+			for (const auto p : neighborhoods.back())
+				for (std::size_t c = 0; c < 3; c++)
+					columns[c].push_back(grid.position(p)[static_cast<int>(c)]);
+			offsets.push_back(static_cast<std::uint32_t>(columns[0].size()));
+		}
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", " << centers.size()
+				  << " balls over " << static_cast<double>(columns[0].size()) / centers.size() << " points\n";
+		const auto inner = radius * (1 - BPA::emptyBallTolerance);
+		const auto report = [&](const char* variant, double time, std::size_t empty) {
+			std::cout << "  " << std::left << std::setw(8) << variant << std::right
+					  << " tests " << std::setw(9) << centers.size() / time / 1000.0 << " M/s"
+					  << "   empty " << std::setw(7) << empty << " / " << centers.size() << "\n";
+		};
+		constexpr auto repeats = 10;
+		{
+			std::size_t empty = 0;
+			const auto start = Clock::now();
+			for (auto r = 0; r < repeats; r++)
+				for (std::size_t b = 0; b < centers.size(); b++)
+					empty += legacyBallIsEmpty(centers[b], neighborhoods[b], grid, inner * inner);
+			report("legacy", millisecondsSince(start) / repeats, empty / repeats);
+		}
+		const auto detected = BPA::detectSimdLevel();
+		for (const auto& [level, levelName] : {std::pair{BPA::SimdLevel::scalar, "scalar"}, std::pair{BPA::SimdLevel::sse2, "sse2"}, std::pair{BPA::SimdLevel::avx2, "avx2"}}) {
+			if (level > detected)
+				continue;
+			const auto anyWithinRadius = BPA::anyWithinRadiusKernel(level);
+			std::size_t empty = 0;
+			const auto start = Clock::now();
+			for (auto r = 0; r < repeats; r++) {
+				for (std::size_t b = 0; b < centers.size(); b++) {
+					const auto o = offsets[b];
+					empty += BPA::ballIsEmpty(centers[b], {columns[0].data() + o, columns[1].data() + o, columns[2].data() + o}, offsets[b + 1] - o, radius, anyWithinRadius);
+				}
+			}
+			report(levelName, millisecondsSince(start) / repeats, empty / repeats);
+		}
+	}
+
+	//the seed loop before the pruning: the neighborhood sorted by length, every ordered pair, no rejection before the ball
+	auto legacySeedInCells(BPA::Grid& grid, const std::vector<std::uint8_t>& used, float radius, BPA::SeedBuffers& buffers, BPA::SeedCursor& cursor,
+		BPA::SeedCounters& counters) -> std::optional<BPA::SeedResult> {
+		//the same relative tolerance as the library's emptiness test, so both loops accept the same balls
+		const auto inner = radius * (1 - BPA::emptyBallTolerance);
+		for (; cursor.cell < grid.cellCount(); cursor.cell++, cursor.point = BPA::noPoint) {
+			const auto cell = grid.cell(cursor.cell);
+			if (cursor.point == BPA::noPoint) {
+				auto normalSum = glm::vec3{};
+				for (auto p = cell.first; p < cell.last; p++)
+					normalSum += grid.normal(p);
+				cursor.avgNormal = glm::normalize(normalSum);
+				cursor.point = cell.first;
+			}
+			for (; cursor.point < cell.last; cursor.point++) {
+				const auto p1 = cursor.point;
+				if (used[p1])
+					continue;
+				const auto p1Pos = grid.position(p1);
+				auto& neighborhood = buffers.neighborhood;
+				grid.sphericalNeighborhood(p1Pos, {p1}, neighborhood);
+				std::sort(begin(neighborhood), end(neighborhood), [&](std::uint32_t a, std::uint32_t b) {
+					return glm::length(grid.position(a) - p1Pos) < glm::length(grid.position(b) - p1Pos);
+				});
+				for (auto p2 : neighborhood) {
+					if (used[p2]) continue;
+					for (auto p3 : neighborhood) {
+						if (p2 == p3 || used[p3]) continue;
+						counters.pairs++;
+						BPA::MeshFace f{{p1, p2, p3}};
+						const auto t = BPA::triangle(grid, f);
+						if (glm::dot(t.normal(), cursor.avgNormal) < 0)
+							continue;
+						counters.balls++;
+						const auto ballCenter = BPA::computeBallCenter(t, radius);
+						if (!ballCenter)
+							continue;
+						counters.emptinessTests++;
+						if (legacyBallIsEmpty(ballCenter.value(), neighborhood, grid, inner * inner))
+							return BPA::SeedResult{f, ballCenter.value()};
+					}
+				}
+			}
+		}
+		return {};
+	}
+
+	//takes every seed the search finds one after another, without growing any of them, and counts the work per seed
+	void benchmarkSeeds(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", seed enumeration\n";
+		BPA::Grid grid(points, radius);
+		const BPA::NeighborLists lists;
+		for (const auto pruned : {false, true}) {
+			std::vector<std::uint8_t> used(grid.size());
+			BPA::SeedBuffers buffers;
+			BPA::SeedCursor cursor;
+			BPA::SeedCounters counters;
+			std::size_t seeds = 0;
+			const auto start = Clock::now();
+			while (const auto seed = pruned ? BPA::findSeedInCells<true>(grid, lists, used, {0, grid.size()}, radius, buffers, cursor, grid.cellCount(), counters)
+											: legacySeedInCells(grid, used, radius, buffers, cursor, counters)) {
+				for (const auto p : seed->f)
+					used[p] = true;
+				seeds++;
+			}
+			const auto time = millisecondsSince(start);
+			const auto perSeed = [&](std::uint64_t count) { return static_cast<double>(count) / std::max<std::size_t>(seeds, 1); };
+			std::cout << "  " << std::left << std::setw(8) << (pruned ? "pruned" : "legacy") << std::right
+					  << " seeds " << std::setw(7) << seeds
+					  << "   pairs/seed " << std::setw(8) << perSeed(counters.pairs)
+					  << "   balls/seed " << std::setw(7) << perSeed(counters.balls)
+					  << "   emptiness tests/seed " << std::setw(7) << perSeed(counters.emptinessTests)
+					  << "   time/seed " << std::setw(7) << time * 1000.0 / std::max<std::size_t>(seeds, 1) << " us\n";
+		}
+	}
+
+	//the parallel seed search over thread counts, on a cloud where the first seed lies behind many cells without one
+	void benchmarkSeedSearch(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", seed search threads\n";
+		const auto hardware = std::max(1u, std::thread::hardware_concurrency());
+		for (auto threads = 1u;; threads = std::min(threads * 2, hardware)) {
+			BPA::ReconstructionOptions options;
+			options.threads = threads;
+			const auto start = Clock::now();
+			const auto triangles = BPA::reconstruct(points, radius, options);
+			std::cout << "  threads " << std::setw(3) << threads
+					  << "   reconstruct " << std::setw(9) << millisecondsSince(start) << " ms"
+					  << "   triangles " << triangles.size() << "\n";
+			if (threads == hardware)
+				break;
+		}
+	}
+
+	//what is wrong with a mesh: border edges with only one triangle (the rims of the holes and of the open parts of the surface),
+	//non-manifold edges with more than two, triangles over the same three points as an earlier one, in either orientation, and
+	//directed edges in more than one triangle, whose triangles do not agree on the orientation
+	struct MeshDefects {
+		std::size_t borderEdges = 0;
+		std::size_t nonManifoldEdges = 0;
+		std::size_t duplicateFaces = 0;
+		std::size_t duplicateDirectedEdges = 0;
+	};
+
+	//the number of repeats of the keys after the first of each
+	auto repeats(std::vector<std::uint64_t>& keys) -> std::size_t {
+		std::sort(begin(keys), end(keys));
+		return static_cast<std::size_t>(end(keys) - std::unique(begin(keys), end(keys)));
+	}
+
+	auto meshDefects(const std::vector<std::uint32_t>& indices) -> MeshDefects {
+		MeshDefects defects;
+		std::vector<std::uint64_t> edges;
+		std::vector<std::uint64_t> directed;
+		std::vector<std::uint64_t> faces;
+		edges.reserve(indices.size());
+		directed.reserve(indices.size());
+		faces.reserve(indices.size() / 3);
+		for (std::size_t i = 0; i < indices.size(); i += 3) {
+			for (std::size_t k = 0; k < 3; k++) {
+				const auto a = indices[i + k];
+				const auto b = indices[i + (k + 1) % 3];
+				edges.push_back(std::uint64_t{std::min(a, b)} << 32 | std::max(a, b));
+				directed.push_back(std::uint64_t{a} << 32 | b);
+			}
+			//the points of a face sorted, packed into 21 bits each, enough for the benchmark's clouds
+			std::array<std::uint64_t, 3> f{indices[i], indices[i + 1], indices[i + 2]};
+			std::sort(begin(f), end(f));
+			faces.push_back(f[0] << 42 | f[1] << 21 | f[2]);
+		}
+		std::sort(begin(edges), end(edges));
+		for (std::size_t i = 0; i < edges.size();) {
+			auto j = i;
+			while (j < edges.size() && edges[j] == edges[i])
+				j++;
+			defects.borderEdges += j - i == 1;
+			defects.nonManifoldEdges += j - i > 2;
+			i = j;
+		}
+		defects.duplicateFaces = repeats(faces);
+		defects.duplicateDirectedEdges = repeats(directed);
+		return defects;
+	}
+
+	//a parallel reconstruction must give the same mesh with any number of threads, without duplicate faces and without more
+	//non-manifold edges than the serial one. reconstructs with options and 1 up to all hardware threads, at least 4, and
+	//reports what breaks this
+	void checkParallelMesh(const std::string& label, const std::vector<BPA::Point>& points, float radius, BPA::ReconstructionOptions options,
+		const MeshDefects& serial) {
+		const auto most = std::max(4u, std::thread::hardware_concurrency());
+		std::vector<std::uint32_t> single;
+		auto passed = true;
+		for (auto threads = 1u;; threads = std::min(threads * 2, most)) {
+			options.threads = threads;
+			const auto indices = BPA::reconstructIndexed(points, radius, options);
+			const auto defects = meshDefects(indices);
+			if (threads == 1)
+				single = indices;
+			else if (indices != single) {
+				std::cout << "  " << label << ": the mesh of " << threads << " threads differs from the one of 1 thread!!!\n";
+				passed = false;
+			}
+			if (defects.duplicateFaces > 0 || defects.nonManifoldEdges > serial.nonManifoldEdges) {
+				std::cout << "  " << label << ", threads " << threads << ": " << defects.duplicateFaces << " duplicate faces, "
+						  << defects.nonManifoldEdges << " non-manifold edges, the serial mesh has " << serial.nonManifoldEdges << "!!!\n";
+				passed = false;
+			}
+			if (threads == most)
+				break;
+		}
+		if (passed)
+			std::cout << "  " << label << ": the same mesh with 1 to " << most << " threads, no duplicate faces, no more non-manifold edges than serial\n";
+	}
+
+	//the tiled reconstruction with growing thread counts and four tiles per thread, against one tile, in Morton cell order
+	void benchmarkTiles(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", tiles\n";
+		BPA::ReconstructionOptions options;
+		options.cellOrder = BPA::CellOrder::morton;
+		auto start = Clock::now();
+		const auto serial = BPA::reconstructIndexed(points, radius, options);
+		const auto serialTime = millisecondsSince(start);
+		const auto serialTriangles = serial.size() / 3;
+		std::cout << "  1 tile                reconstruct " << std::setw(9) << serialTime << " ms   triangles " << serialTriangles << "\n";
+		const auto hardware = std::max(1u, std::thread::hardware_concurrency());
+		for (auto threads = 1u;; threads = std::min(threads * 2, hardware)) {
+			options.threads = threads;
+			options.tiles = 4 * threads;
+			start = Clock::now();
+			const auto triangles = BPA::reconstructIndexed(points, radius, options).size() / 3;
+			const auto time = millisecondsSince(start);
+			std::cout << "  " << std::setw(3) << options.tiles << " tiles, threads " << std::setw(3) << threads
+					  << "   reconstruct " << std::setw(9) << time << " ms"
+					  << "   triangles " << triangles << " (" << static_cast<std::int64_t>(triangles) - static_cast<std::int64_t>(serialTriangles) << ")"
+					  << "   speedup " << serialTime / time << "\n";
+			if (threads == hardware)
+				break;
+		}
+		options.tiles = 16;
+		checkParallelMesh("16 tiles", points, radius, options, meshDefects(serial));
+	}
+
+	//pivot batches of 256 edges with growing thread counts, against pivoting one edge after the other, on one surface
+	void benchmarkPivotBatches(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", pivot batches\n";
+		BPA::ReconstructionOptions options;
+		auto start = Clock::now();
+		const auto serial = BPA::reconstructIndexed(points, radius, options);
+		const auto serialTime = millisecondsSince(start);
+		const auto serialTriangles = serial.size() / 3;
+		std::cout << "  batch   1                reconstruct " << std::setw(9) << serialTime << " ms   triangles " << serialTriangles << "\n";
+		const auto hardware = std::max(1u, std::thread::hardware_concurrency());
+		options.pivotBatch = 256;
+		for (auto threads = 1u;; threads = std::min(threads * 2, hardware)) {
+			options.threads = threads;
+			start = Clock::now();
+			const auto triangles = BPA::reconstructIndexed(points, radius, options).size() / 3;
+			const auto time = millisecondsSince(start);
+			std::cout << "  batch " << std::setw(3) << options.pivotBatch << ", threads " << std::setw(3) << threads
+					  << "   reconstruct " << std::setw(9) << time << " ms"
+					  << "   triangles " << triangles << " (" << static_cast<std::int64_t>(triangles) - static_cast<std::int64_t>(serialTriangles) << ")"
+					  << "   speedup " << serialTime / time << "\n";
+			if (threads == hardware)
+				break;
+		}
+		const auto serialDefects = meshDefects(serial);
+		checkParallelMesh("batch 256", points, radius, options, serialDefects);
+		options.tiles = 16;
+		checkParallelMesh("batch 256, 16 tiles", points, radius, options, serialDefects);
+	}
+
+	//passes over increasing radii against single radii: the passes should close most holes of the smallest radius in about its
+	//time. a pass must not add defects: no triangle may come out twice, and there may be no more directed edges in two triangles
+	//than with the smallest radius alone, for the grid and the k-d tree
+	void benchmarkRadii(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius passes\n";
+		const std::vector<std::vector<float>> runs{{radius / 2}, {radius}, {radius * 2.5f}, {radius / 2, radius}, {radius / 2, radius, radius * 2.5f}};
+		for (const auto& [index, indexName] : {std::pair{BPA::SpatialIndexType::grid, "grid"}, std::pair{BPA::SpatialIndexType::kdTree, "kd-tree"}}) {
+			BPA::ReconstructionOptions options;
+			options.spatialIndex = index;
+			//the defects of the single radii, by radius
+			std::vector<std::pair<float, MeshDefects>> single;
+			for (const auto& radii : runs) {
+				std::string label = indexName;
+				for (const auto r : radii) {
+					std::ostringstream text;
+					text << std::defaultfloat << r;
+					label += " " + text.str();
+				}
+				const auto start = Clock::now();
+				const auto indices = BPA::reconstructIndexed(points, radii, options);
+				const auto time = millisecondsSince(start);
+				const auto defects = meshDefects(indices);
+				std::cout << "  " << std::left << std::setw(30) << label << std::right
+						  << " reconstruct " << std::setw(9) << time << " ms"
+						  << "   triangles " << indices.size() / 3
+						  << "   border edges " << defects.borderEdges
+						  << "   non-manifold edges " << defects.nonManifoldEdges
+						  << "   duplicate faces " << defects.duplicateFaces
+						  << "   duplicate directed edges " << defects.duplicateDirectedEdges << "\n";
+				if (radii.size() == 1) {
+					single.emplace_back(radii.front(), defects);
+					continue;
+				}
+				const auto first = std::find_if(begin(single), end(single), [&](const auto& s) { return s.first == radii.front(); });
+				if (defects.duplicateFaces > 0 || (first != end(single) && defects.duplicateDirectedEdges > first->second.duplicateDirectedEdges))
+					std::cout << "  the passes emitted triangles twice or against the orientation of the mesh!!!\n";
+				//the passes should close about the holes the last radius alone closes
+				const auto last = std::find_if(begin(single), end(single), [&](const auto& s) { return s.first == radii.back(); });
+				if (last != end(single) && defects.borderEdges > 2 * last->second.borderEdges)
+					std::cout << "  the passes left " << defects.borderEdges << " border edges, more than twice the " << last->second.borderEdges << " of the last radius alone!!!\n";
+			}
+		}
+	}
+
+	//the grid resolutions: how many points a query distance tests per point it returns, and what the finer cells cost
+	void benchmarkResolutions(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << ", grid resolutions\n";
+		for (const auto& [resolution, resolutionName] : {std::pair{BPA::GridResolution::twiceRadius, "2r"}, std::pair{BPA::GridResolution::radius, "r"}, std::pair{BPA::GridResolution::halfRadius, "r/2"}}) {
+			const auto buildStart = Clock::now();
+			BPA::Grid grid(points, radius, BPA::CellOrder::linear, BPA::GridBackend::automatic, resolution);
+			const auto buildTime = millisecondsSince(buildStart);
+
+			std::size_t runs = 0;
+			std::size_t candidates = 0;
+			std::size_t hits = 0;
+			for (const auto& p : points) {
+				grid.forEachCellRun(p.pos, [&](std::uint32_t first, std::uint32_t last) {
+					runs++;
+					candidates += grid.cellStart[last + 1] - grid.cellStart[first];
+				});
+			}
+			const auto queryStart = Clock::now();
+			for (const auto& p : points)
+				grid.forEachNeighbor(p.pos, [&](std::uint32_t) { hits++; });
+			const auto queryTime = millisecondsSince(queryStart);
+
+			BPA::ReconstructionOptions options;
+			options.gridResolution = resolution;
+			const auto reconstructStart = Clock::now();
+			BPA::reconstruct(points, radius, options);
+			const auto reconstructTime = millisecondsSince(reconstructStart);
+
+			std::cout << "  " << std::left << std::setw(4) << resolutionName << std::setw(7) << (grid.sparse ? "sparse" : "dense") << std::right
+					  << " build " << std::setw(8) << buildTime << " ms"
+					  << "   runs/query " << std::setw(6) << static_cast<double>(runs) / points.size()
+					  << "   tested/hit " << static_cast<double>(candidates) / std::max<std::size_t>(hits, 1)
+					  << "   queries " << std::setw(9) << points.size() / queryTime * 1000.0 << " /s"
+					  << "   reconstruct " << std::setw(8) << reconstructTime << " ms\n";
+		}
+	}
+
+	//reconstruction with on-the-fly grid queries against precomputed neighbor lists, over growing neighborhood sizes
+	void benchmarkNeighborSearch(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, grid queries against precomputed neighbor lists\n";
+		for (const auto factor : {1.0f, 1.5f, 2.0f, 3.0f}) {
+			BPA::Grid grid(points, radius * factor);
+			std::size_t hits = 0;
+			for (std::size_t i = 0; i < points.size(); i += 97)
+				grid.forEachNeighbor(points[i].pos, [&](std::uint32_t) { hits++; });
+			const auto density = static_cast<double>(hits) / ((points.size() + 96) / 97);
+
+			double times[2];
+			for (const auto search : {BPA::NeighborSearch::grid, BPA::NeighborSearch::precomputed}) {
+				BPA::ReconstructionOptions options;
+				options.neighborSearch = search;
+				//the lists are built on all hardware threads
+				options.threads = 0;
+				const auto start = Clock::now();
+				BPA::reconstruct(points, radius * factor, options);
+				times[static_cast<int>(search)] = millisecondsSince(start);
+			}
+			std::cout << "  neighbors " << std::setw(7) << density
+					  << "   grid " << std::setw(9) << times[0] << " ms"
+					  << "   precomputed " << std::setw(9) << times[1] << " ms"
+					  << "   speedup " << times[0] / times[1] << "\n";
+		}
+	}
+
+	//the peak heap is what the reconstruction needs on top of the input points, the indices it returns included
+	void runReconstruct(const char* variant, const std::vector<BPA::Point>& points, float radius, const BPA::ReconstructionOptions& options) {
+		const auto allocationsBefore = allocationCount.load();
+		const auto heapBefore = liveHeapBytes.load();
+		peakHeapBytes = heapBefore;
+		const auto start = Clock::now();
+		const auto indices = BPA::reconstructIndexed(points, radius, options);
+		const auto time = millisecondsSince(start);
+		const auto allocations = allocationCount - allocationsBefore;
+		const auto triangles = indices.size() / 3;
+		std::cout << "  " << std::left << std::setw(8) << variant << std::right
+				  << " reconstruct " << std::setw(9) << time << " ms"
+				  << "   triangles " << triangles
+				  << "   allocs/triangle " << static_cast<double>(allocations) / std::max<std::size_t>(triangles, 1)
+				  << "   peak heap " << (peakHeapBytes - heapBefore) / 1048576.0 << " MB"
+				  << " (" << static_cast<double>(peakHeapBytes - heapBefore) / points.size() << " bytes/point, "
+				  << static_cast<double>(peakHeapBytes - heapBefore) / std::max<std::size_t>(triangles, 1) << " bytes/triangle)"
+				  << "   rate " << triangles / time / 1000.0 << " M triangles/s\n";
+	}
+
+	void benchmarkReconstruct(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << "\n";
+		runReconstruct("linear", points, radius, {});
+		BPA::ReconstructionOptions morton;
+		morton.cellOrder = BPA::CellOrder::morton;
+		runReconstruct("morton", points, radius, morton);
+	}
+
+	//one row of the spatial index matrix: building and querying every index on one density profile, then reconstructing with it
+	void benchmarkSpatialIndices(const std::string& name, const std::vector<BPA::Point>& points, float radius) {
+		std::cout << name << ": " << points.size() << " points, radius " << std::defaultfloat << radius << std::fixed << "\n";
+		benchmarkGrid("grid", points, [&] { return BPA::Grid(points, radius); });
+		benchmarkGrid("kd-tree", points, [&] { return BPA::KdTree(points, radius); });
+		benchmarkGrid("octree", points, [&] { return BPA::Octree(points, radius); });
+		for (const auto& [index, indexName] : {std::pair{BPA::SpatialIndexType::grid, "grid"}, std::pair{BPA::SpatialIndexType::kdTree, "kd-tree"}, std::pair{BPA::SpatialIndexType::octree, "octree"}}) {
+			BPA::ReconstructionOptions options;
+			options.spatialIndex = index;
+			runReconstruct(indexName, points, radius, options);
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	const char* plyPath = argc > 1 ? argv[1] : "../input/bunny.ply";
+	const auto plyRadius = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 0.002f;
+	const auto syntheticCount = argc > 3 ? static_cast<std::size_t>(std::atol(argv[3])) : std::size_t{200000};
+
+	std::cout << std::fixed << std::setprecision(2);
+
+	const auto bunny = loadPly(plyPath);
+	if (bunny.empty())
+		std::cerr << "could not read " << plyPath << ", skipping it\n";
+	else {
+		benchmarkGrids(plyPath, bunny, plyRadius);
+		benchmarkReconstruct(plyPath, bunny, plyRadius);
+		benchmarkResolutions(plyPath, bunny, plyRadius);
+		benchmarkSeeds(plyPath, bunny, plyRadius);
+		benchmarkPivotKernels(plyPath, bunny, plyRadius, 20000);
+		benchmarkEmptyBall(plyPath, bunny, plyRadius, 20000);
+		benchmarkRadii(plyPath, bunny, plyRadius);
+		benchmarkTiles(plyPath, bunny, plyRadius);
+		benchmarkPivotBatches(plyPath, bunny, plyRadius);
+
+		//every point twice: ignoring by position drops the copy of the query point, ignoring by id keeps it
+		auto twice = bunny;
+		twice.insert(end(twice), begin(bunny), end(bunny));
+		std::cout << "duplicated points: " << twice.size() << " points, radius " << std::defaultfloat << plyRadius << std::fixed << "\n";
+		benchmarkGrid("legacy", twice, [&] { return LegacyGrid(twice, plyRadius); });
+		benchmarkGrid("csr", twice, [&] { return BPA::Grid(twice, plyRadius); });
+		benchmarkReconstruct("duplicated points", twice, plyRadius);
+	}
+
+	const auto sphere = shuffled(syntheticSphere(syntheticCount));
+	benchmarkGrids("sphere", sphere, syntheticRadius(syntheticCount));
+	benchmarkReconstruct("sphere", sphere, syntheticRadius(syntheticCount));
+
+	benchmarkResolutions("sphere", sphere, syntheticRadius(syntheticCount));
+	benchmarkResolutions("dense cube", shuffled(syntheticCube(syntheticCount)), 0.02f);
+
+	benchmarkSeeds("sphere", sphere, syntheticRadius(syntheticCount));
+	benchmarkSeedSearch("wires", syntheticWires(syntheticCount / 4, 10000, syntheticRadius(10000)), syntheticRadius(10000));
+	benchmarkTiles("sphere", sphere, syntheticRadius(syntheticCount));
+	benchmarkPivotBatches("sphere", sphere, syntheticRadius(syntheticCount));
+
+	benchmarkNeighborSearch("sphere", shuffled(syntheticSphere(syntheticCount / 4)), syntheticRadius(syntheticCount / 4));
+
+	//the spatial indices over density profiles from uniform to strongly varying
+	benchmarkSpatialIndices("uniform sphere", sphere, syntheticRadius(syntheticCount));
+	benchmarkSpatialIndices("scanned wall", shuffled(syntheticScan(syntheticCount / 4)), 0.02f);
+	benchmarkSpatialIndices("clustered spheres", shuffled(syntheticClusters(syntheticCount)), syntheticRadius(syntheticCount / 8));
+
+	const auto cube = syntheticCube(1000000);
+	benchmarkKernels("dense cube", cube, 0.02f, 100000);
+	benchmarkPivotKernels("dense cube", cube, 0.02f, 20000);
+	benchmarkEmptyBall("dense cube", cube, 0.02f, 20000);
+
+	//two spheres a kilometre apart: the bounding box has far too many cells for a dense grid
+	auto pair = sphere;
+	for (const auto& p : sphere)
+		pair.push_back({p.pos + glm::vec3{1000.0f}, p.normal});
+	std::cout << "sphere pair: " << pair.size() << " points, radius " << std::defaultfloat << syntheticRadius(syntheticCount) << std::fixed << "\n";
+	benchmarkGrid("sparse", pair, [&] { return BPA::Grid(pair, syntheticRadius(syntheticCount)); });
+	return 0;
+}
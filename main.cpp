@@ -15,11 +15,8 @@
 #include <vector>
 #include "./BPA/BallPivotingAlgorithm.h"
 #include "./rply/rply.h"
-#include <unordered_map>
-#include <chrono>
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include <sstream>
+#include <string>
 
 
 
@@ -62,6 +59,33 @@ static int vertex_cb(p_ply_argument argument) {
 
 
 
+//prints where the time of the reconstruction went, and what it did if the library counts it
+static void print_stats(const BPA::ReconstructionStats& stats) {
+  std::cout<<"time spent:"<< static_cast<long long>(stats.totalSeconds * 1000) << "ms"
+           <<" (index "<< stats.indexSeconds * 1000 <<"ms, neighbor lists "<< stats.neighborListSeconds * 1000
+           <<"ms, seed search "<< stats.seedSeconds * 1000 <<"ms, tiles "<< stats.tileSeconds * 1000
+           <<"ms, pivot loop "<< stats.pivotSeconds * 1000 <<"ms)"<<std::endl;
+  if (stats.neighborListFallback)
+    std::cout<<"the neighbor lists needed too much memory, the index was queried instead"<<std::endl;
+  for (size_t w = 0; w < stats.workers.size(); w++)
+    std::cout<<"worker "<< w <<": tasks "<< stats.workers[w].tasks <<", stolen "<< stats.workers[w].stolen
+             <<", utilization "<< 100 * stats.workers[w].utilization() <<"%"<<std::endl;
+  if (!stats.counted)
+    return;
+  const auto& c = stats.counters;
+  std::cout<<"seeds "<< c.seeds <<" (pairs "<< c.seedPairs <<", balls "<< c.seedBalls <<", empty ball tests "<< c.seedEmptyBallTests <<")"<<std::endl;
+  std::cout<<"pivots attempted "<< c.pivots <<", succeeded "<< c.pivotTriangles <<", candidates "<< c.candidates
+           <<", missed "<< c.missed <<", inner edge rejections "<< c.innerEdgeRejections <<", empty ball tests "<< c.emptyBallTests
+           <<", non-empty balls "<< c.nonEmptyBalls <<", batches "<< c.batches <<", retries "<< c.retries <<std::endl;
+  std::cout<<"glue cases 1-4: "<< c.glueCases[0] <<" "<< c.glueCases[1] <<" "<< c.glueCases[2] <<" "<< c.glueCases[3]
+           <<", boundary edges "<< c.boundaryEdges <<", peak front edges "<< c.peakFrontEdges <<std::endl;
+  std::cout<<"neighborhood sizes:";
+  for (size_t b = 0; b < c.neighborhoodSizes.size(); b++)
+    if (c.neighborhoodSizes[b] > 0)
+      std::cout<<" "<< (b == 0 ? 0 : 1u << (b - 1)) << (b + 1 == c.neighborhoodSizes.size() ? "+" : "") <<": "<< c.neighborhoodSizes[b];
+  std::cout<<std::endl;
+}
+
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
@@ -103,29 +127,31 @@ int main()
     if (!ply_read(input)) return 1;
     ply_close(input);
 
-    //set the ball's radius
-    double radius = 0.002;
-    std::cout<<"input radius:";
-    std::cin>>radius;
-    std::cout<<"radius is"<< radius <<std::endl;
-
-    //do the BPA reconstrcution, which returns faces in a vector, record the elapsed time
-    auto start = std::chrono::system_clock::now();
-    std::vector<BPA::Triangle> triangles = BPA::reconstruct(points, radius);
-    auto end = std::chrono::system_clock::now();
-    std::cout<<"time spent:"<< std::chrono::duration_cast<std::chrono::milliseconds>
-    (end-start).count()<< "ms" <<std::endl;
-
-    //use an map to store all the points number in INT form, which makes the output process easier
-    std::unordered_map<glm::vec3, int> um;
-    for (int i = 0; i < points.size(); i++) {
-        um[points[i].pos] = i;
-    }
+    //set the ball's radius, several increasing radii on one line run one pass per radius, the larger ones close the holes
+    std::vector<float> radii;
+    std::cout<<"input radius (or increasing radii):";
+    std::string radiusLine;
+    std::getline(std::cin, radiusLine);
+    std::istringstream radiusStream(radiusLine);
+    for (float radius; radiusStream >> radius;)
+        radii.push_back(radius);
+    if (radii.empty())
+        radii.push_back(0.002f);
+    std::cout<<"radius is";
+    for (auto radius : radii)
+        std::cout<<" "<< radius;
+    std::cout<<std::endl;
+
+    //do the BPA reconstrcution, which returns faces as indices of the points (three per face), and print where its time went
+    BPA::ReconstructionStats stats;
+    std::vector<std::uint32_t> indices = BPA::reconstructIndexed(points, radii, BPA::ReconstructionOptions{}, stats);
+    print_stats(stats);
 
     //store faces
     std::vector<glm::ivec3> faces;
-    for (auto triangle : triangles) {
-        faces.emplace_back(um[triangle[0]], um[triangle[1]], um[triangle[2]]);
+    faces.reserve(indices.size() / 3);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        faces.emplace_back(indices[i], indices[i + 1], indices[i + 2]);
     }
 
     //write in the output file, we have vertex from points, and face from faces 